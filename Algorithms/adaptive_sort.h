@@ -0,0 +1,520 @@
+#ifndef ADAPTIVE_SORT_H
+#define ADAPTIVE_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/*
+Sorts that take advantage of order already in the input. std::sort (introsort in GCC)
+does about the same O(n log n) work on a sorted vector as on a shuffled one, but data
+often arrives nearly sorted: appended to a sorted log, sorted in reverse, or with only a
+handful of distinct keys.
+
+- PdqSort (pattern-defeating quicksort, see https://arxiv.org/abs/2106.05123) is an
+  unstable drop in for std::sort. It is introsort plus a few checks: a partition that
+  moved nothing hints the range is sorted, so it tries to finish with an insertion sort
+  that gives up after a few moves; a pivot equal to the one before puts all the equal
+  elements in place at once, so few distinct keys take O(n k) rather than O(n log n);
+  and bad pivots get the range shuffled a little before falling back to heapsort.
+- PowerSort (see https://arxiv.org/abs/1805.04154, what CPython's list.sort uses now)
+  is a stable drop in for std::stable_sort. It is a merge sort over the runs already in
+  the input (descending runs get reversed), so a sorted or reversed input is one run
+  and costs n - 1 comparisons, and a sorted input with an unsorted tail costs little
+  more than sorting the tail.
+
+Both take the same comp as std::sort (a strict weak ordering).
+*/
+
+// Ranges below this are insertion sorted by PdqSort
+constexpr size_t PDQ_INSERTION_SORT_THRESHOLD{24};
+// Ranges above this use the median of three medians of three (Tukey's ninther) as the pivot
+constexpr size_t PDQ_NINTHER_THRESHOLD{128};
+// Moves PdqPartialInsertionSort makes before deciding the range isn't nearly sorted
+constexpr size_t PDQ_PARTIAL_INSERTION_SORT_LIMIT{8};
+// Runs shorter than this are extended with an insertion sort before PowerSort merges them
+constexpr size_t POWERSORT_MIN_RUN{32};
+
+// Stable insertion sort of [first, last) where [first, sorted_end) is already sorted
+template <typename RandomIt, typename Compare>
+void InsertionSort(RandomIt first, RandomIt sorted_end, RandomIt last, Compare comp)
+{
+    if (first == last)
+    {
+        return;
+    }
+    for (RandomIt itr = std::max(sorted_end, first + 1); itr != last; ++itr)
+    {
+        if (!comp(*itr, *(itr - 1)))
+        {
+            continue;
+        }
+        auto e{std::move(*itr)};
+        RandomIt hole{itr};
+        do
+        {
+            *hole = std::move(*(hole - 1));
+            --hole;
+        } while (hole != first && comp(e, *(hole - 1)));
+        *hole = std::move(e);
+    }
+}
+
+// Insertion sort that knows an element no bigger than any in [first, last) is just before first, so it skips the hole != first check
+template <typename RandomIt, typename Compare>
+void PdqUnguardedInsertionSort(RandomIt first, RandomIt last, Compare comp)
+{
+    for (RandomIt itr = first + 1; itr < last; ++itr)
+    {
+        if (!comp(*itr, *(itr - 1)))
+        {
+            continue;
+        }
+        auto e{std::move(*itr)};
+        RandomIt hole{itr};
+        do
+        {
+            *hole = std::move(*(hole - 1));
+            --hole;
+        } while (comp(e, *(hole - 1)));
+        *hole = std::move(e);
+    }
+}
+
+// Insertion sort that gives up (returning false) once it has moved elements PDQ_PARTIAL_INSERTION_SORT_LIMIT places in total
+template <typename RandomIt, typename Compare>
+bool PdqPartialInsertionSort(RandomIt first, RandomIt last, Compare comp)
+{
+    if (first == last)
+    {
+        return true;
+    }
+    size_t moves{0};
+    for (RandomIt itr = first + 1; itr != last; ++itr)
+    {
+        if (!comp(*itr, *(itr - 1)))
+        {
+            continue;
+        }
+        auto e{std::move(*itr)};
+        RandomIt hole{itr};
+        do
+        {
+            *hole = std::move(*(hole - 1));
+            --hole;
+        } while (hole != first && comp(e, *(hole - 1)));
+        *hole = std::move(e);
+        moves += static_cast<size_t>(itr - hole);
+        if (moves > PDQ_PARTIAL_INSERTION_SORT_LIMIT)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sorts *a, *b, *c
+template <typename RandomIt, typename Compare>
+void PdqSort3(RandomIt a, RandomIt b, RandomIt c, Compare comp)
+{
+    if (comp(*b, *a))
+    {
+        std::iter_swap(a, b);
+    }
+    if (comp(*c, *b))
+    {
+        std::iter_swap(b, c);
+    }
+    if (comp(*b, *a))
+    {
+        std::iter_swap(a, b);
+    }
+}
+
+/*
+Partitions [first, last) around the pivot *first into elements less than it, the pivot,
+and elements not less than it. Returns where the pivot ended up and whether no elements
+had to be swapped. The median of three choice guarantees an element not less than the
+pivot to stop the first scan, and when the first scan stopped right away, the second
+scan needs a bounds check.
+*/
+template <typename RandomIt, typename Compare>
+std::pair<RandomIt, bool> PdqPartitionRight(RandomIt first, RandomIt last, Compare comp)
+{
+    auto pivot{std::move(*first)};
+    RandomIt left{first};
+    RandomIt right{last};
+    while (comp(*++left, pivot))
+    {
+    }
+    if (left - 1 == first)
+    {
+        while (left < right && !comp(*--right, pivot))
+        {
+        }
+    }
+    else
+    {
+        while (!comp(*--right, pivot))
+        {
+        }
+    }
+    bool already_partitioned{left >= right};
+    while (left < right)
+    {
+        std::iter_swap(left, right);
+        while (comp(*++left, pivot))
+        {
+        }
+        while (!comp(*--right, pivot))
+        {
+        }
+    }
+    RandomIt pivot_position{left - 1};
+    *first = std::move(*pivot_position);
+    *pivot_position = std::move(pivot);
+    return {pivot_position, already_partitioned};
+}
+
+/*
+Like PdqPartitionRight but elements equal to the pivot go left. Used when the pivot is
+equal to the element before the range (the pivot of an earlier partition), so nothing in
+the range is less than it: everything that lands left of the returned position equals
+the pivot and is already in place.
+*/
+template <typename RandomIt, typename Compare>
+RandomIt PdqPartitionLeft(RandomIt first, RandomIt last, Compare comp)
+{
+    auto pivot{std::move(*first)};
+    RandomIt left{first};
+    RandomIt right{last};
+    while (comp(pivot, *--right))
+    {
+    }
+    if (right + 1 == last)
+    {
+        while (left < right && !comp(pivot, *++left))
+        {
+        }
+    }
+    else
+    {
+        while (!comp(pivot, *++left))
+        {
+        }
+    }
+    while (left < right)
+    {
+        std::iter_swap(left, right);
+        while (comp(pivot, *--right))
+        {
+        }
+        while (!comp(pivot, *++left))
+        {
+        }
+    }
+    *first = std::move(*right);
+    *right = std::move(pivot);
+    return right;
+}
+
+/*
+Sorts [first, last), recursing on the left side and looping on the right. leftmost is
+false when the element before first is a previous pivot (no bigger than anything in the
+range). bad_allowed is how many very unbalanced partitions are left before giving up
+on quicksort and heapsorting, which keeps the worst case O(n log n) as in introsort.
+*/
+template <typename RandomIt, typename Compare>
+void PdqSortLoop(RandomIt first, RandomIt last, Compare comp, unsigned bad_allowed, bool leftmost)
+{
+    while (true)
+    {
+        size_t size{static_cast<size_t>(last - first)};
+        if (size < PDQ_INSERTION_SORT_THRESHOLD)
+        {
+            if (leftmost)
+            {
+                InsertionSort(first, first, last, comp);
+            }
+            else
+            {
+                PdqUnguardedInsertionSort(first, last, comp);
+            }
+            return;
+        }
+
+        // The pivot ends up at *first
+        size_t half{size / 2};
+        if (size > PDQ_NINTHER_THRESHOLD)
+        {
+            PdqSort3(first, first + half, last - 1, comp);
+            PdqSort3(first + 1, first + (half - 1), last - 2, comp);
+            PdqSort3(first + 2, first + (half + 1), last - 3, comp);
+            PdqSort3(first + (half - 1), first + half, first + (half + 1), comp);
+            std::iter_swap(first, first + half);
+        }
+        else
+        {
+            PdqSort3(first + half, first, last - 1, comp);
+        }
+
+        // Same pivot as the partition before, so every element equal to it can be put in place now
+        if (!leftmost && !comp(*(first - 1), *first))
+        {
+            first = PdqPartitionLeft(first, last, comp) + 1;
+            continue;
+        }
+
+        auto [pivot_position, already_partitioned]{PdqPartitionRight(first, last, comp)};
+        size_t left_size{static_cast<size_t>(pivot_position - first)};
+        size_t right_size{static_cast<size_t>(last - (pivot_position + 1))};
+        if (left_size < size / 8 || right_size < size / 8)
+        {
+            if (--bad_allowed == 0)
+            {
+                std::make_heap(first, last, comp);
+                std::sort_heap(first, last, comp);
+                return;
+            }
+            // Swap a few elements into new places, which breaks up the patterns that make the median choice bad
+            if (left_size >= PDQ_INSERTION_SORT_THRESHOLD)
+            {
+                std::iter_swap(first, first + left_size / 4);
+                std::iter_swap(pivot_position - 1, pivot_position - left_size / 4);
+                if (left_size > PDQ_NINTHER_THRESHOLD)
+                {
+                    std::iter_swap(first + 1, first + (left_size / 4 + 1));
+                    std::iter_swap(first + 2, first + (left_size / 4 + 2));
+                    std::iter_swap(pivot_position - 2, pivot_position - (left_size / 4 + 1));
+                    std::iter_swap(pivot_position - 3, pivot_position - (left_size / 4 + 2));
+                }
+            }
+            if (right_size >= PDQ_INSERTION_SORT_THRESHOLD)
+            {
+                std::iter_swap(pivot_position + 1, pivot_position + (1 + right_size / 4));
+                std::iter_swap(last - 1, last - right_size / 4);
+                if (right_size > PDQ_NINTHER_THRESHOLD)
+                {
+                    std::iter_swap(pivot_position + 2, pivot_position + (2 + right_size / 4));
+                    std::iter_swap(pivot_position + 3, pivot_position + (3 + right_size / 4));
+                    std::iter_swap(last - 2, last - (1 + right_size / 4));
+                    std::iter_swap(last - 3, last - (2 + right_size / 4));
+                }
+            }
+        }
+        else if (already_partitioned && PdqPartialInsertionSort(first, pivot_position, comp) &&
+                 PdqPartialInsertionSort(pivot_position + 1, last, comp))
+        {
+            // Nothing moved in the partition, and both sides turned out to be (nearly) sorted
+            return;
+        }
+
+        PdqSortLoop(first, pivot_position, comp, bad_allowed, leftmost);
+        first = pivot_position + 1;
+        leftmost = false;
+    }
+}
+
+// Same result as std::sort, near linear time on sorted, reversed and few distinct values inputs
+template <typename RandomIt, typename Compare = std::less<>>
+void PdqSort(RandomIt first, RandomIt last, Compare comp = Compare())
+{
+    size_t n{static_cast<size_t>(last - first)};
+    if (n < 2)
+    {
+        return;
+    }
+    unsigned log2_n{0};
+    while ((n >> log2_n) > 1)
+    {
+        log2_n++;
+    }
+    PdqSortLoop(first, last, comp, log2_n, true);
+}
+
+/*
+Finds the run starting at first (reversing it if it is descending, keeping equal
+elements in their order) and returns its end. Runs shorter than
+POWERSORT_MIN_RUN are extended to that length with an insertion sort, since merging many
+tiny runs costs more than sorting them directly.
+*/
+template <typename RandomIt, typename Compare>
+RandomIt PowerSortRun(RandomIt first, RandomIt last, Compare comp)
+{
+    RandomIt run_end{first + 1};
+    if (run_end == last)
+    {
+        return last;
+    }
+    if (comp(*run_end, *first))
+    {
+        // Blocks of equal elements are reversed on their own first, so reversing the whole run puts them back in order
+        RandomIt equal_begin{first};
+        for (; run_end != last && !comp(*(run_end - 1), *run_end); ++run_end)
+        {
+            if (comp(*run_end, *(run_end - 1)))
+            {
+                std::reverse(equal_begin, run_end);
+                equal_begin = run_end;
+            }
+        }
+        std::reverse(equal_begin, run_end);
+        std::reverse(first, run_end);
+    }
+    else
+    {
+        while (++run_end != last && !comp(*run_end, *(run_end - 1)))
+        {
+        }
+    }
+    if (static_cast<size_t>(run_end - first) < POWERSORT_MIN_RUN && run_end != last)
+    {
+        RandomIt extended_end{first + std::min<size_t>(POWERSORT_MIN_RUN, static_cast<size_t>(last - first))};
+        InsertionSort(first, run_end, extended_end, comp);
+        run_end = extended_end;
+    }
+    return run_end;
+}
+
+/*
+The power of the boundary between runs [begin1, begin2) and [begin2, end2) out of n: the
+depth at which the two runs' midpoints would first be split apart by repeatedly halving
+[0, n). PowerSort merges runs in order of decreasing power, which builds a merge tree
+close to the one that balances the run lengths best. a and b are twice the midpoints,
+and the loop compares their binary expansions as fractions of n bit by bit.
+*/
+inline unsigned PowerSortNodePower(size_t begin1, size_t begin2, size_t end2, size_t n)
+{
+    uint64_t a{static_cast<uint64_t>(begin1) + begin2};
+    uint64_t b{static_cast<uint64_t>(begin2) + end2};
+    unsigned power{0};
+    while (true)
+    {
+        power++;
+        if (a >= n)
+        {
+            a -= n;
+            b -= n;
+        }
+        else if (b >= n)
+        {
+            return power;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+}
+
+/*
+Stable merge of the sorted ranges [first, middle) and [middle, last). Elements at the
+start of the left run that are no bigger than the first of the right run, and at the end
+of the right run that are no smaller than the last of the left run, are already in place
+and get skipped with binary searches, which is what makes merging an unsorted tail into
+a long sorted run cheap. Then the shorter side is moved to buffer and merged back.
+*/
+template <typename RandomIt, typename Compare, typename T>
+void PowerSortMerge(RandomIt first, RandomIt middle, RandomIt last, std::vector<T> &buffer, Compare comp)
+{
+    first = std::upper_bound(first, middle, *middle, comp);
+    if (first == middle)
+    {
+        return;
+    }
+    last = std::lower_bound(middle, last, *(middle - 1), comp);
+    if (middle - first <= last - middle)
+    {
+        buffer.assign(std::make_move_iterator(first), std::make_move_iterator(middle));
+        auto left{buffer.begin()};
+        RandomIt right{middle};
+        RandomIt out{first};
+        while (left != buffer.end() && right != last)
+        {
+            // Ties take the left element, which came first
+            if (comp(*right, *left))
+            {
+                *out++ = std::move(*right++);
+            }
+            else
+            {
+                *out++ = std::move(*left++);
+            }
+        }
+        std::move(left, buffer.end(), out);
+    }
+    else
+    {
+        buffer.assign(std::make_move_iterator(middle), std::make_move_iterator(last));
+        auto right{buffer.end()};
+        RandomIt left{middle};
+        RandomIt out{last};
+        while (right != buffer.begin() && left != first)
+        {
+            // Ties take the right element, which goes after
+            if (comp(*(right - 1), *(left - 1)))
+            {
+                *--out = std::move(*--left);
+            }
+            else
+            {
+                *--out = std::move(*--right);
+            }
+        }
+        std::move_backward(buffer.begin(), right, out);
+    }
+}
+
+// Same result as std::stable_sort, near linear time on inputs made of a few sorted or reversed runs
+template <typename RandomIt, typename Compare = std::less<>>
+void PowerSort(RandomIt first, RandomIt last, Compare comp = Compare())
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    size_t n{static_cast<size_t>(last - first)};
+    if (n < 2)
+    {
+        return;
+    }
+
+    struct Run
+    {
+        size_t begin;
+        size_t end;
+        // Power of the boundary between this run and the one before it on the stack
+        unsigned power;
+    };
+    // The powers on the stack only increase, so it never holds more than about log2(n) runs
+    std::vector<Run> stack;
+    std::vector<T> buffer;
+    auto MergeTop{[&]
+                  {
+        Run right{stack.back()};
+        stack.pop_back();
+        PowerSortMerge(first + stack.back().begin, first + right.begin, first + right.end, buffer, comp);
+        stack.back().end = right.end; }};
+
+    size_t begin{0};
+    while (begin < n)
+    {
+        size_t end{static_cast<size_t>(PowerSortRun(first + begin, last, comp) - first)};
+        unsigned power{0};
+        if (!stack.empty())
+        {
+            power = PowerSortNodePower(stack.back().begin, begin, end, n);
+            while (stack.size() > 1 && stack.back().power > power)
+            {
+                MergeTop();
+            }
+        }
+        stack.push_back({begin, end, power});
+        begin = end;
+    }
+    while (stack.size() > 1)
+    {
+        MergeTop();
+    }
+}
+
+#endif
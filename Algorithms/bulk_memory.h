@@ -0,0 +1,248 @@
+#ifndef BULK_MEMORY_H
+#define BULK_MEMORY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "parallel.h"
+#include "simd.h"
+
+/*
+fill and copy for buffers much bigger than the cache (hundreds of MB and up). A normal
+store first reads the cache line it writes into (a "read for ownership"), so filling a
+buffer moves every byte over the memory bus twice, and the buffer pushes everything
+else out of the cache on its way through. Non-temporal (streaming) stores skip the
+cache: they collect a whole 64 byte line in a write combining buffer and send it
+straight to memory, see:
+https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html#text=stream
+
+That's only a win when the data won't be read again soon, since afterwards none of it
+is in the cache, so below BULK_STREAMING_THRESHOLD bytes these are plain std::fill and
+std::copy. Above it the buffer is split across threads, since one core usually can't
+use all of the memory bandwidth on its own.
+
+Elements must be trivially copyable, as they're written as bytes. The ranges must be
+contiguous (vector, array, pointers), and for BulkCopy they must not overlap.
+*/
+
+// Below this many bytes, fill and copy use normal stores, the data is likely to still be in the cache when it's next used
+constexpr size_t BULK_STREAMING_THRESHOLD{size_t{1} << 23};
+// Streaming stores go out a cache line at a time, so the kernels write whole aligned lines
+constexpr size_t CACHE_LINE_SIZE{64};
+
+#ifdef SIMD_X86
+
+/*
+Kernels write bytes (a multiple of CACHE_LINE_SIZE) to dst (aligned to CACHE_LINE_SIZE).
+Fills repeat an 8 byte pattern. The sfence at the end makes the streaming stores, which
+are weakly ordered, visible before anything written after them, in particular before
+another thread is told the buffer is ready (by joining).
+*/
+__attribute__((target("sse2"))) inline void SSE2StreamFill(uint8_t *dst, size_t bytes, uint64_t pattern)
+{
+    __m128i v{_mm_set1_epi64x(static_cast<long long>(pattern))};
+    for (size_t i = 0; i < bytes; i += CACHE_LINE_SIZE)
+    {
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i), v);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 16), v);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 32), v);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 48), v);
+    }
+    _mm_sfence();
+}
+
+__attribute__((target("sse2"))) inline void SSE2StreamCopy(uint8_t *dst, const uint8_t *src, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i += CACHE_LINE_SIZE)
+    {
+        __m128i a{_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))};
+        __m128i b{_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 16))};
+        __m128i c{_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 32))};
+        __m128i d{_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 48))};
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i), a);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 48), d);
+    }
+    _mm_sfence();
+}
+
+__attribute__((target("avx2"))) inline void AVX2StreamFill(uint8_t *dst, size_t bytes, uint64_t pattern)
+{
+    __m256i v{_mm256_set1_epi64x(static_cast<long long>(pattern))};
+    for (size_t i = 0; i < bytes; i += CACHE_LINE_SIZE)
+    {
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + i), v);
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + i + 32), v);
+    }
+    _mm_sfence();
+}
+
+__attribute__((target("avx2"))) inline void AVX2StreamCopy(uint8_t *dst, const uint8_t *src, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i += CACHE_LINE_SIZE)
+    {
+        __m256i a{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i))};
+        __m256i b{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 32))};
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + i), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + i + 32), b);
+    }
+    _mm_sfence();
+}
+
+__attribute__((target("avx512f"))) inline void AVX512StreamFill(uint8_t *dst, size_t bytes, uint64_t pattern)
+{
+    __m512i v{_mm512_set1_epi64(static_cast<long long>(pattern))};
+    for (size_t i = 0; i < bytes; i += CACHE_LINE_SIZE)
+    {
+        _mm512_stream_si512(reinterpret_cast<__m512i *>(dst + i), v);
+    }
+    _mm_sfence();
+}
+
+__attribute__((target("avx512f"))) inline void AVX512StreamCopy(uint8_t *dst, const uint8_t *src, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i += CACHE_LINE_SIZE)
+    {
+        _mm512_stream_si512(reinterpret_cast<__m512i *>(dst + i), _mm512_loadu_si512(src + i));
+    }
+    _mm_sfence();
+}
+
+#endif
+
+// Fills whole cache lines with streaming stores at the given level, or memset-like plain stores at Scalar
+inline void StreamFillLines(uint8_t *dst, size_t bytes, uint64_t pattern, SimdLevel level)
+{
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512StreamFill(dst, bytes, pattern);
+    case SimdLevel::AVX2:
+        return AVX2StreamFill(dst, bytes, pattern);
+    case SimdLevel::SSE2:
+        return SSE2StreamFill(dst, bytes, pattern);
+    default:
+        break;
+    }
+#endif
+    for (size_t i = 0; i < bytes; i += sizeof(pattern))
+    {
+        std::memcpy(dst + i, &pattern, sizeof(pattern));
+    }
+}
+
+inline void StreamCopyLines(uint8_t *dst, const uint8_t *src, size_t bytes, SimdLevel level)
+{
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512StreamCopy(dst, src, bytes);
+    case SimdLevel::AVX2:
+        return AVX2StreamCopy(dst, src, bytes);
+    case SimdLevel::SSE2:
+        return SSE2StreamCopy(dst, src, bytes);
+    default:
+        break;
+    }
+#endif
+    std::memcpy(dst, src, bytes);
+}
+
+// Elements from data until the first cache line boundary (all of [data, data + n) if there's none)
+template <typename T>
+size_t ElementsToCacheLine(const T *data, size_t n)
+{
+    size_t misalignment{reinterpret_cast<uintptr_t>(data) % CACHE_LINE_SIZE};
+    size_t head_bytes{misalignment == 0 ? 0 : CACHE_LINE_SIZE - misalignment};
+    return std::min(n, head_bytes / sizeof(T));
+}
+
+/*
+Like std::fill. level works as in simd.h, SimdLevel::Scalar splits the work across
+threads but uses normal stores (for comparing). Streaming needs value's bytes to repeat
+every 8 bytes, so elements of 1, 2, 4 or 8 bytes that are aligned to their size (as they
+are in any array of them); anything else gets a std::fill per thread.
+*/
+template <typename ContiguousIt, typename T>
+void BulkFill(ContiguousIt first, ContiguousIt last, const T &value, unsigned num_threads = DefaultThreadCount(), SimdLevel level = ActiveSimdLevel())
+{
+    using U = std::iter_value_t<ContiguousIt>;
+    static_assert(std::is_trivially_copyable_v<U>, "BulkFill writes elements as bytes");
+    U *data{std::to_address(first)};
+    size_t n{static_cast<size_t>(last - first)};
+    U element(value);
+    if (n * sizeof(U) < BULK_STREAMING_THRESHOLD)
+    {
+        std::fill(data, data + n, element);
+        return;
+    }
+    bool repeating{false};
+    uint64_t pattern{0};
+    if constexpr (sizeof(pattern) % sizeof(U) == 0)
+    {
+        repeating = reinterpret_cast<uintptr_t>(data) % sizeof(U) == 0;
+        for (size_t offset = 0; offset < sizeof(pattern); offset += sizeof(U))
+        {
+            std::memcpy(reinterpret_cast<uint8_t *>(&pattern) + offset, &element, sizeof(U));
+        }
+    }
+    ParallelChunks(n, ChunkCount(n, num_threads), [&](unsigned, size_t begin, size_t end)
+                   {
+        U *chunk{data + begin};
+        size_t count{end - begin};
+        if (!repeating)
+        {
+            std::fill(chunk, chunk + count, element);
+            return;
+        }
+        // Plain stores up to the first cache line boundary and after the last one
+        size_t head{ElementsToCacheLine(chunk, count)};
+        std::fill(chunk, chunk + head, element);
+        size_t line_bytes{(count - head) * sizeof(U) / CACHE_LINE_SIZE * CACHE_LINE_SIZE};
+        StreamFillLines(reinterpret_cast<uint8_t *>(chunk + head), line_bytes, pattern, level);
+        std::fill(chunk + head + line_bytes / sizeof(U), chunk + count, element); });
+}
+
+/*
+Like std::copy for contiguous ranges that don't overlap, returns the end of the output.
+level works as for BulkFill. Only the stores are streamed: the source is read with
+normal loads (non-temporal loads only skip the cache for special write combining memory,
+like some device memory, not for ordinary RAM).
+*/
+template <typename ContiguousIt, typename OutputContiguousIt>
+OutputContiguousIt BulkCopy(ContiguousIt first, ContiguousIt last, OutputContiguousIt d_first, unsigned num_threads = DefaultThreadCount(), SimdLevel level = ActiveSimdLevel())
+{
+    using U = std::iter_value_t<ContiguousIt>;
+    static_assert(std::is_trivially_copyable_v<U>, "BulkCopy copies elements as bytes");
+    static_assert(std::is_same_v<U, std::iter_value_t<OutputContiguousIt>>, "BulkCopy needs the same element type on both sides");
+    const U *src{std::to_address(first)};
+    U *dst{std::to_address(d_first)};
+    size_t n{static_cast<size_t>(last - first)};
+    if (n * sizeof(U) < BULK_STREAMING_THRESHOLD)
+    {
+        std::copy(src, src + n, dst);
+        return d_first + n;
+    }
+    ParallelChunks(n * sizeof(U), ChunkCount(n * sizeof(U), num_threads), [&](unsigned, size_t begin, size_t end)
+                   {
+        // Byte ranges, since the lines don't have to line up with whole elements when copying
+        uint8_t *out{reinterpret_cast<uint8_t *>(dst) + begin};
+        const uint8_t *in{reinterpret_cast<const uint8_t *>(src) + begin};
+        size_t bytes{end - begin};
+        size_t head{ElementsToCacheLine(out, bytes)};
+        std::memcpy(out, in, head);
+        size_t line_bytes{(bytes - head) / CACHE_LINE_SIZE * CACHE_LINE_SIZE};
+        StreamCopyLines(out + head, in + head, line_bytes, level);
+        std::memcpy(out + head + line_bytes, in + head + line_bytes, bytes - head - line_bytes); });
+    return d_first + n;
+}
+
+#endif
@@ -0,0 +1,335 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "simd.h"
+
+/*
+One pass, vectorized versions of the remove + erase and unique + erase idioms from
+main.cpp, plus copy_if. They work on int arrays with the same mask predicates as
+simd.h ((e & mask) == value, so e.g. is_even is mask 1, value 0).
+
+Each step loads a vector of ints, compares them all at once to get a bit mask of the
+elements to keep, and then "compress stores" them: the kept lanes are packed together
+and written in one store, and the write position moves on by the number kept. There
+are no branches on the data, so unlike std::remove_if it doesn't slow down when the
+keep/remove pattern is unpredictable, see:
+https://en.algorithmica.org/hpc/simd/shuffling/#filtering
+
+AVX-512 has a compress instruction. AVX2 doesn't, so the kept lanes are moved into
+place with a permute whose lane order is looked up from the 8 bit keep mask. SSE2 has
+no instruction to move lanes around by a runtime index, so below AVX2 these use a
+branchless scalar loop.
+
+Everything works in place: the write position never passes the read position, so the
+full vector stores only ever overwrite elements that were already read.
+*/
+
+inline size_t ScalarRemoveMasked(int *data, size_t n, int mask, int value)
+{
+    size_t kept{0};
+    for (size_t i = 0; i < n; i++)
+    {
+        int e{data[i]};
+        data[kept] = e;
+        kept += (e & mask) != value;
+    }
+    return kept;
+}
+
+inline size_t ScalarUnique(int *data, size_t n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+    size_t kept{1};
+    int prev{data[0]};
+    for (size_t i = 1; i < n; i++)
+    {
+        int e{data[i]};
+        data[kept] = e;
+        kept += e != prev;
+        prev = e;
+    }
+    return kept;
+}
+
+inline size_t ScalarCopyIfMasked(const int *src, size_t n, int *dst, int mask, int value)
+{
+    size_t kept{0};
+    for (size_t i = 0; i < n; i++)
+    {
+        dst[kept] = src[i];
+        kept += (src[i] & mask) == value;
+    }
+    return kept;
+}
+
+#ifdef SIMD_X86
+
+// For each 8 bit keep mask, the lanes to gather so the kept ones come first (in order)
+inline const std::array<std::array<int, 8>, 256> &CompressPermutations()
+{
+    static const std::array<std::array<int, 8>, 256> table{[]
+                                                            {
+        std::array<std::array<int, 8>, 256> t{};
+        for (int keep = 0; keep < 256; keep++)
+        {
+            int next{0};
+            for (int lane = 0; lane < 8; lane++)
+            {
+                if (keep & (1 << lane))
+                {
+                    t[keep][next++] = lane;
+                }
+            }
+        }
+        return t; }()};
+    return table;
+}
+
+__attribute__((target("avx2,popcnt"))) inline size_t AVX2CompressStore(int *dst, __m256i v, unsigned keep)
+{
+    __m256i order{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(CompressPermutations()[keep].data()))};
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_permutevar8x32_epi32(v, order));
+    return __builtin_popcount(keep);
+}
+
+// Bit i set when lane i of a compare result matched
+__attribute__((target("avx2"))) inline unsigned AVX2LaneMask(__m256i compare)
+{
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(compare)));
+}
+
+__attribute__((target("avx2,popcnt"))) inline size_t AVX2RemoveMasked(int *data, size_t n, int mask, int value)
+{
+    const __m256i masks{_mm256_set1_epi32(mask)};
+    const __m256i values{_mm256_set1_epi32(value)};
+    size_t kept{0};
+    size_t i{0};
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i))};
+        unsigned removed{AVX2LaneMask(_mm256_cmpeq_epi32(_mm256_and_si256(v, masks), values))};
+        kept += AVX2CompressStore(data + kept, v, ~removed & 0xFF);
+    }
+    // Fewer than 8 left, finish like ScalarRemoveMasked
+    for (; i < n; i++)
+    {
+        data[kept] = data[i];
+        kept += (data[i] & mask) != value;
+    }
+    return kept;
+}
+
+__attribute__((target("avx2,popcnt"))) inline size_t AVX2Unique(int *data, size_t n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+    // Lane i of previous holds element i - 1, built from the current vector shifted up one lane plus the last element of the one before
+    const __m256i shift_up{_mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6)};
+    size_t kept{1};
+    int prev{data[0]};
+    size_t i{1};
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i))};
+        __m256i previous{_mm256_blend_epi32(_mm256_permutevar8x32_epi32(v, shift_up), _mm256_set1_epi32(prev), 1)};
+        unsigned duplicates{AVX2LaneMask(_mm256_cmpeq_epi32(v, previous))};
+        prev = _mm256_extract_epi32(v, 7);
+        kept += AVX2CompressStore(data + kept, v, ~duplicates & 0xFF);
+    }
+    for (; i < n; i++)
+    {
+        int e{data[i]};
+        data[kept] = e;
+        kept += e != prev;
+        prev = e;
+    }
+    return kept;
+}
+
+__attribute__((target("avx2,popcnt"))) inline size_t AVX2CopyIfMasked(const int *src, size_t n, int *dst, int mask, int value)
+{
+    const __m256i masks{_mm256_set1_epi32(mask)};
+    const __m256i values{_mm256_set1_epi32(value)};
+    size_t kept{0};
+    size_t i{0};
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i))};
+        kept += AVX2CompressStore(dst + kept, v, AVX2LaneMask(_mm256_cmpeq_epi32(_mm256_and_si256(v, masks), values)));
+    }
+    return kept + ScalarCopyIfMasked(src + i, n - i, dst + kept, mask, value);
+}
+
+__attribute__((target("avx512f,popcnt"))) inline size_t AVX512RemoveMasked(int *data, size_t n, int mask, int value)
+{
+    const __m512i masks{_mm512_set1_epi32(mask)};
+    const __m512i values{_mm512_set1_epi32(value)};
+    size_t kept{0};
+    for (size_t i = 0; i < n; i += 16)
+    {
+        // Masked loads and stores handle the tail, lanes past n are neither read nor kept
+        __mmask16 in_range{static_cast<__mmask16>(n - i >= 16 ? 0xFFFF : (1u << (n - i)) - 1)};
+        __m512i v{_mm512_maskz_loadu_epi32(in_range, data + i)};
+        __mmask16 keep{_mm512_mask_cmpneq_epi32_mask(in_range, _mm512_and_si512(v, masks), values)};
+        int count{__builtin_popcount(keep)};
+        _mm512_mask_storeu_epi32(data + kept, static_cast<__mmask16>((1u << count) - 1), _mm512_maskz_compress_epi32(keep, v));
+        kept += count;
+    }
+    return kept;
+}
+
+__attribute__((target("avx512f,popcnt"))) inline size_t AVX512Unique(int *data, size_t n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+    size_t kept{1};
+    // Last loaded vector, whose lane 15 is the element before the next vector
+    __m512i last{_mm512_set1_epi32(data[0])};
+    for (size_t i = 1; i < n; i += 16)
+    {
+        __mmask16 in_range{static_cast<__mmask16>(n - i >= 16 ? 0xFFFF : (1u << (n - i)) - 1)};
+        __m512i v{_mm512_maskz_loadu_epi32(in_range, data + i)};
+        // alignr concatenates v:last and shifts by 15 lanes, giving [last[15], v[0], ..., v[14]]
+        __m512i previous{_mm512_maskz_alignr_epi32(0xFFFF, v, last, 15)};
+        __mmask16 keep{_mm512_mask_cmpneq_epi32_mask(in_range, v, previous)};
+        int count{__builtin_popcount(keep)};
+        _mm512_mask_storeu_epi32(data + kept, static_cast<__mmask16>((1u << count) - 1), _mm512_maskz_compress_epi32(keep, v));
+        kept += count;
+        last = v;
+    }
+    return kept;
+}
+
+__attribute__((target("avx512f,popcnt"))) inline size_t AVX512CopyIfMasked(const int *src, size_t n, int *dst, int mask, int value)
+{
+    const __m512i masks{_mm512_set1_epi32(mask)};
+    const __m512i values{_mm512_set1_epi32(value)};
+    size_t kept{0};
+    for (size_t i = 0; i < n; i += 16)
+    {
+        __mmask16 in_range{static_cast<__mmask16>(n - i >= 16 ? 0xFFFF : (1u << (n - i)) - 1)};
+        __m512i v{_mm512_maskz_loadu_epi32(in_range, src + i)};
+        __mmask16 keep{_mm512_mask_cmpeq_epi32_mask(in_range, _mm512_and_si512(v, masks), values)};
+        int count{__builtin_popcount(keep)};
+        _mm512_mask_storeu_epi32(dst + kept, static_cast<__mmask16>((1u << count) - 1), _mm512_maskz_compress_epi32(keep, v));
+        kept += count;
+    }
+    return kept;
+}
+
+#endif
+
+/*
+Like std::remove_if with the predicate (e & mask) == value: moves the elements to keep
+to the front (in order) and returns how many there are. Unlike std::remove, what is left
+after them is unspecified rather than moved-from.
+*/
+inline size_t SimdRemoveMasked(int *data, size_t n, int mask, int value, SimdLevel level = ActiveSimdLevel())
+{
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512RemoveMasked(data, n, mask, value);
+    case SimdLevel::AVX2:
+        return AVX2RemoveMasked(data, n, mask, value);
+    default:
+        break;
+    }
+#endif
+    return ScalarRemoveMasked(data, n, mask, value);
+}
+
+// Like std::remove(data, data + n, value)
+inline size_t SimdRemove(int *data, size_t n, int value, SimdLevel level = ActiveSimdLevel())
+{
+    return SimdRemoveMasked(data, n, ~0, value, level);
+}
+
+// Like std::unique, keeps the first of each run of equal adjacent elements and returns how many were kept
+inline size_t SimdUnique(int *data, size_t n, SimdLevel level = ActiveSimdLevel())
+{
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512Unique(data, n);
+    case SimdLevel::AVX2:
+        return AVX2Unique(data, n);
+    default:
+        break;
+    }
+#endif
+    return ScalarUnique(data, n);
+}
+
+/*
+Like std::copy_if with the predicate (e & mask) == value, returns the number copied.
+dst needs room for n elements (not just the number copied) since whole vectors are
+stored, and it must not overlap src unless dst == src.
+*/
+inline size_t SimdCopyIfMasked(const int *src, size_t n, int *dst, int mask, int value, SimdLevel level = ActiveSimdLevel())
+{
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512CopyIfMasked(src, n, dst, mask, value);
+    case SimdLevel::AVX2:
+        return AVX2CopyIfMasked(src, n, dst, mask, value);
+    default:
+        break;
+    }
+#endif
+    return ScalarCopyIfMasked(src, n, dst, mask, value);
+}
+
+// The erase half of the idiom, optionally giving the freed capacity back (shrink_to_fit reallocates)
+inline size_t EraseAfter(std::vector<int> &vec, size_t new_size, bool shrink)
+{
+    vec.resize(new_size);
+    if (shrink)
+    {
+        vec.shrink_to_fit();
+    }
+    return new_size;
+}
+
+// remove + erase in one call, returns the new size
+inline size_t SimdRemoveMasked(std::vector<int> &vec, int mask, int value, bool shrink = false)
+{
+    return EraseAfter(vec, SimdRemoveMasked(vec.data(), vec.size(), mask, value), shrink);
+}
+
+inline size_t SimdRemove(std::vector<int> &vec, int value, bool shrink = false)
+{
+    return EraseAfter(vec, SimdRemove(vec.data(), vec.size(), value), shrink);
+}
+
+// unique + erase in one call, returns the new size
+inline size_t SimdUnique(std::vector<int> &vec, bool shrink = false)
+{
+    return EraseAfter(vec, SimdUnique(vec.data(), vec.size()), shrink);
+}
+
+// Returns a new vector of the elements of src with (e & mask) == value
+inline std::vector<int> SimdCopyIfMasked(const std::vector<int> &src, int mask, int value, bool shrink = false)
+{
+    std::vector<int> dst(src.size());
+    EraseAfter(dst, SimdCopyIfMasked(src.data(), src.size(), dst.data(), mask, value), shrink);
+    return dst;
+}
+
+#endif
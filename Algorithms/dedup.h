@@ -0,0 +1,313 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+
+/*
+Removing duplicates that aren't next to each other. std::unique only drops adjacent
+duplicates (see vec17 in main.cpp), so the usual fix is sort then unique, which takes
+O(n log n) and loses the original order. Here each element is looked up in a hash set of
+the elements seen so far and kept only the first time, which is O(n) and keeps the
+first occurrence of each value where it was.
+
+std::unordered_set would work, but it allocates a node per element and chains them in
+linked lists (see Sets), so every lookup is a pointer chase. OpenAddressingSet stores the
+keys in one array: a key goes in the slot its hash picks, or the next free slot after
+it (linear probing), so a lookup reads a few neighbouring slots, usually in the same
+cache line. It is sized up front from the input length so it never has to grow.
+*/
+
+// Odd 64 bit constants (from the golden ratio and splitmix64), multiplying by them spreads the bits of a hash
+constexpr uint64_t HASH_MULTIPLIER{0x9E3779B97F4A7C15ull};
+constexpr uint64_t PARTITION_MULTIPLIER{0xBF58476D1CE4E5B9ull};
+
+// How many elements ahead of the one being inserted to prefetch the slot of
+constexpr size_t DEDUP_PREFETCH_DISTANCE{16};
+
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class OpenAddressingSet
+{
+private:
+    // Key and whether the slot is used side by side, so checking a slot is one cache miss rather than two
+    struct Slot
+    {
+        T key;
+        bool used;
+    };
+
+    std::vector<Slot> slots;
+    size_t num_keys;
+    // log2 of the capacity, the slot is the top bits of the mixed hash
+    unsigned bits;
+    Hash hash;
+    KeyEqual equal;
+
+    /*
+    std::hash<int> is the identity, so the raw hash of nearby ints would fill neighbouring
+    slots and make long probe runs. Multiplying mixes every bit into the top bits.
+    */
+    size_t SlotIndex(const T &key) const
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(hash(key)) * HASH_MULTIPLIER) >> (64 - bits));
+    }
+
+    void Rehash(unsigned new_bits)
+    {
+        std::vector<Slot> old_slots(std::move(slots));
+        bits = new_bits;
+        slots.assign(size_t{1} << bits, Slot{T(), false});
+        num_keys = 0;
+        for (const auto &slot : old_slots)
+        {
+            if (slot.used)
+            {
+                Insert(slot.key);
+            }
+        }
+    }
+
+public:
+    // Room for expected_size keys with the table at most half full
+    explicit OpenAddressingSet(size_t expected_size = 0, Hash h = Hash(), KeyEqual eq = KeyEqual()) : num_keys(0), bits(4), hash(h), equal(eq)
+    {
+        while ((size_t{1} << bits) < 2 * expected_size)
+        {
+            bits++;
+        }
+        slots.assign(size_t{1} << bits, Slot{T(), false});
+    }
+
+    // Adds key if it isn't there yet, returns whether it was added (like unordered_set::insert(key).second)
+    bool Insert(const T &key)
+    {
+        // Grow past 3/4 full, probe runs get long quickly after that
+        if (4 * (num_keys + 1) > 3 * slots.size())
+        {
+            Rehash(bits + 1);
+        }
+        size_t mask{slots.size() - 1};
+        for (size_t i = SlotIndex(key);; i = (i + 1) & mask)
+        {
+            if (!slots[i].used)
+            {
+                slots[i] = Slot{key, true};
+                num_keys++;
+                return true;
+            }
+            if (equal(slots[i].key, key))
+            {
+                return false;
+            }
+        }
+    }
+
+    bool Contains(const T &key) const
+    {
+        size_t mask{slots.size() - 1};
+        for (size_t i = SlotIndex(key); slots[i].used; i = (i + 1) & mask)
+        {
+            if (equal(slots[i].key, key))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+    Asks for the slot key would start probing at to be loaded into cache. On a table much
+    bigger than the cache nearly every lookup misses, so calling this some elements ahead
+    of the Insert lets those misses overlap instead of happening one after another.
+    */
+    void Prefetch(const T &key) const
+    {
+        __builtin_prefetch(&slots[SlotIndex(key)]);
+    }
+
+    size_t size() const
+    {
+        return num_keys;
+    }
+};
+
+/*
+Like std::unique, but removes every duplicate rather than only adjacent ones, keeping the
+first occurrence of each value in its original order. Returns the new end, and like
+std::unique what is left after it is moved-from.
+*/
+template <typename ForwardIt, typename Hash = std::hash<typename std::iterator_traits<ForwardIt>::value_type>>
+ForwardIt HashUnique(ForwardIt first, ForwardIt last, Hash hash = Hash())
+{
+    using T = typename std::iterator_traits<ForwardIt>::value_type;
+    OpenAddressingSet<T, Hash> seen(static_cast<size_t>(std::distance(first, last)), hash);
+    ForwardIt result{first};
+    // DEDUP_PREFETCH_DISTANCE elements ahead of itr (or last)
+    ForwardIt ahead{first};
+    for (size_t i = 0; i < DEDUP_PREFETCH_DISTANCE && ahead != last; i++)
+    {
+        ++ahead;
+    }
+    for (ForwardIt itr = first; itr != last; ++itr)
+    {
+        if (ahead != last)
+        {
+            seen.Prefetch(*ahead);
+            ++ahead;
+        }
+        if (seen.Insert(*itr))
+        {
+            if (result != itr)
+            {
+                *result = std::move(*itr);
+            }
+            ++result;
+        }
+    }
+    return result;
+}
+
+/*
+Like std::unique_copy but removing every duplicate (as HashUnique does), with the work
+split across threads. d_first must be random access (e.g. a vector with room for n
+elements) since each thread writes its own part of the output. Returns the end of the
+output.
+
+Each value is assigned to one of num_threads partitions by its hash, and each thread owns
+the hash set for one partition, so equal values always meet in the same set and no set
+is shared between threads. Once every chunk has counted its elements per partition,
+the chunks scatter their indices into one array grouped by partition and, within that,
+by chunk, so each partition's indices end up contiguous and in increasing order, and
+its thread only reads its own share of the input instead of all of it. Walking them in
+order, the first occurrence of a value is the one its partition's thread keeps. A
+thread records the indices it keeps (in increasing order), then the input is split into
+chunks again and each chunk copies its kept elements to the output, at offsets found by
+summing the chunk counts. Writing keep flags into one shared array instead would have
+threads writing into the same cache lines all the time.
+*/
+template <typename RandomIt, typename OutputIt, typename Hash = std::hash<typename std::iterator_traits<RandomIt>::value_type>>
+OutputIt ParallelHashUniqueCopy(RandomIt first, RandomIt last, OutputIt d_first, unsigned num_threads = DefaultThreadCount(), Hash hash = Hash())
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    size_t n{static_cast<size_t>(last - first)};
+    // Partitions are numbered with a byte
+    unsigned num_chunks{std::min(ChunkCount(n, num_threads), 256u)};
+    if (num_chunks == 1)
+    {
+        OpenAddressingSet<T, Hash> seen(n, hash);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (i + DEDUP_PREFETCH_DISTANCE < n)
+            {
+                seen.Prefetch(first[i + DEDUP_PREFETCH_DISTANCE]);
+            }
+            if (seen.Insert(first[i]))
+            {
+                *d_first = first[i];
+                ++d_first;
+            }
+        }
+        return d_first;
+    }
+
+    // Partition of each element, a byte per element so the scatter pass doesn't hash again
+    std::vector<uint8_t> partitions(n);
+    std::vector<std::vector<size_t>> partition_sizes(num_chunks, std::vector<size_t>(num_chunks));
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        for (size_t i = begin; i < end; i++)
+        {
+            // Top 32 bits of the mixed hash scaled to [0, num_chunks)
+            uint64_t mixed{static_cast<uint64_t>(hash(first[i])) * PARTITION_MULTIPLIER};
+            uint8_t partition{static_cast<uint8_t>(((mixed >> 32) * num_chunks) >> 32)};
+            partitions[i] = partition;
+            partition_sizes[chunk][partition]++;
+        } });
+
+    // Where each (chunk, partition) bucket starts in indices: partition by partition, then chunk by chunk
+    std::vector<std::vector<size_t>> bucket_starts(num_chunks, std::vector<size_t>(num_chunks));
+    std::vector<size_t> partition_starts(num_chunks + 1, 0);
+    size_t start{0};
+    for (unsigned partition = 0; partition < num_chunks; partition++)
+    {
+        partition_starts[partition] = start;
+        for (unsigned chunk = 0; chunk < num_chunks; chunk++)
+        {
+            bucket_starts[chunk][partition] = start;
+            start += partition_sizes[chunk][partition];
+        }
+    }
+    partition_starts[num_chunks] = start;
+
+    std::vector<size_t> indices(n);
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        std::vector<size_t> &next{bucket_starts[chunk]};
+        for (size_t i = begin; i < end; i++)
+        {
+            indices[next[partitions[i]]++] = i;
+        } });
+
+    std::vector<std::vector<size_t>> kept(num_chunks);
+    ParallelChunks(n, num_chunks, [&](unsigned partition, size_t, size_t)
+                   {
+        size_t begin{partition_starts[partition]};
+        size_t end{partition_starts[partition + 1]};
+        OpenAddressingSet<T, Hash> seen(end - begin, hash);
+        for (size_t j = begin; j < end; j++)
+        {
+            if (j + DEDUP_PREFETCH_DISTANCE < end)
+            {
+                seen.Prefetch(first[indices[j + DEDUP_PREFETCH_DISTANCE]]);
+            }
+            if (seen.Insert(first[indices[j]]))
+            {
+                kept[partition].push_back(indices[j]);
+            }
+        } });
+
+    // For each chunk, mark its kept elements (from every partition's list) and count them
+    std::vector<std::vector<uint8_t>> keep(num_chunks);
+    std::vector<size_t> counts(num_chunks);
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        keep[chunk].assign(end - begin, 0);
+        size_t count{0};
+        for (const auto &indices : kept)
+        {
+            auto itr{std::lower_bound(indices.cbegin(), indices.cend(), begin)};
+            for (; itr != indices.cend() && *itr < end; ++itr)
+            {
+                keep[chunk][*itr - begin] = 1;
+                count++;
+            }
+        }
+        counts[chunk] = count; });
+
+    std::vector<size_t> offsets(num_chunks, 0);
+    for (unsigned i = 1; i < num_chunks; i++)
+    {
+        offsets[i] = offsets[i - 1] + counts[i - 1];
+    }
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        OutputIt out{d_first + offsets[chunk]};
+        for (size_t i = begin; i < end; i++)
+        {
+            if (keep[chunk][i - begin])
+            {
+                *out = first[i];
+                ++out;
+            }
+        } });
+    return d_first + (offsets.back() + counts.back());
+}
+
+#endif
@@ -0,0 +1,462 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+
+/*
+Sorting a binary file of fixed size records (e.g. ints, or structs of plain data) that
+is bigger than the memory we're willing to use, the classic external merge sort, see:
+https://en.wikipedia.org/wiki/External_sorting
+
+1. Runs: read as many records as fit in the memory budget, sort them (ParallelSort),
+   and write them to a temporary run file. Repeat until the input is used up.
+2. Merge: read all the runs at once through a buffer each and repeatedly write out
+   the smallest front record, picked with a loser tree (below). If there are too many
+   runs for each to get a decently sized buffer within the budget, groups of them are
+   merged into longer runs first, so the data may go through the disk more than once.
+
+Disks (especially spinning ones) are fast at big sequential reads and writes and slow
+at small scattered ones, so every read and write here moves io_buffer_size bytes at a
+time. The records are read and written as raw bytes, so the file must have been written
+on a machine with the same layout for T (endianness, padding).
+
+Errors (missing input, a file size that isn't a whole number of records, a failed
+read or write) throw std::runtime_error. Run files are deleted even when that happens.
+*/
+
+// Progress and throughput counters, passed to ExternalSortOptions::on_progress as the sort goes and returned at the end
+struct ExternalSortStats
+{
+    size_t records{0};
+    size_t runs{0};
+    // Merge passes that wrote intermediate runs, 0 when every run was merged straight into the output
+    size_t extra_merge_passes{0};
+    size_t bytes_read{0};
+    size_t bytes_written{0};
+    double run_seconds{0.0};
+    double merge_seconds{0.0};
+
+    // Bytes read and written per second over the whole sort, in MB (10^6 bytes)
+    double ThroughputMBPerSecond() const
+    {
+        double seconds{run_seconds + merge_seconds};
+        return seconds > 0.0 ? (bytes_read + bytes_written) / seconds / 1e6 : 0.0;
+    }
+};
+
+struct ExternalSortOptions
+{
+    // Bytes of records held in memory at once while making runs, and split between the run buffers while merging
+    size_t memory_budget{size_t{256} << 20};
+    // Bytes moved by each read or write
+    size_t io_buffer_size{size_t{4} << 20};
+    // Where run files go, it needs room for a copy of the input
+    std::filesystem::path temp_dir{std::filesystem::temp_directory_path()};
+    unsigned num_threads{DefaultThreadCount()};
+    // Called after each run is written and after each io_buffer_size of merged output, may be empty
+    std::function<void(const ExternalSortStats &)> on_progress;
+};
+
+/*
+A tournament tree for merging k sorted sequences, see:
+https://en.wikipedia.org/wiki/K-way_merge_algorithm#Tournament_Tree
+
+The leaves are the front elements of the k sequences and each internal node remembers
+the loser of the match played there, with the overall winner (smallest) kept in
+tree[0]. When the winner's sequence moves on to its next element, only the matches on
+the path from its leaf to the root are replayed, against the losers stored there: that's
+log2(k) comparisons, one per level, where a binary heap needs up to two per level.
+
+Sequences are given as pointers to their front elements, nullptr once a sequence is
+used up (which loses every match). Ties go to the lower sequence index, so merging runs
+in input order keeps equal records in input order.
+*/
+template <typename T, typename Compare = std::less<>>
+class LoserTree
+{
+private:
+    std::vector<const T *> heads;
+    // tree[0] is the winner, tree[1, k) the losers at each internal node (node i's children are 2i and 2i + 1, leaf j is node k + j)
+    std::vector<size_t> tree;
+    Compare comp;
+
+    bool Beats(size_t a, size_t b) const
+    {
+        if (heads[a] == nullptr)
+        {
+            return false;
+        }
+        if (heads[b] == nullptr)
+        {
+            return true;
+        }
+        if (comp(*heads[a], *heads[b]))
+        {
+            return true;
+        }
+        return !comp(*heads[b], *heads[a]) && a < b;
+    }
+
+public:
+    explicit LoserTree(std::vector<const T *> fronts, Compare c = Compare()) : heads(std::move(fronts)), tree(std::max<size_t>(1, heads.size())), comp(c)
+    {
+        size_t k{heads.size()};
+        if (k <= 1)
+        {
+            tree[0] = 0;
+            return;
+        }
+        // Winners of each node's subtree while building bottom up, leaves are nodes [k, 2k)
+        std::vector<size_t> winners(2 * k);
+        for (size_t j = 0; j < k; j++)
+        {
+            winners[k + j] = j;
+        }
+        for (size_t node = k - 1; node >= 1; node--)
+        {
+            size_t left{winners[2 * node]}, right{winners[2 * node + 1]};
+            bool left_wins{Beats(left, right)};
+            winners[node] = left_wins ? left : right;
+            tree[node] = left_wins ? right : left;
+        }
+        tree[0] = winners[1];
+    }
+
+    // Index of the sequence with the smallest front element
+    size_t Winner() const
+    {
+        return tree[0];
+    }
+
+    // The smallest front element, nullptr when every sequence is used up
+    const T *Top() const
+    {
+        return heads.empty() ? nullptr : heads[tree[0]];
+    }
+
+    // Moves the winning sequence on to next (nullptr if it's used up) and finds the new winner
+    void ReplaceWinner(const T *next)
+    {
+        size_t winner{tree[0]};
+        heads[winner] = next;
+        size_t k{heads.size()};
+        for (size_t node = (k + winner) / 2; node >= 1; node /= 2)
+        {
+            if (Beats(tree[node], winner))
+            {
+                std::swap(tree[node], winner);
+            }
+        }
+        tree[0] = winner;
+    }
+};
+
+// Reads a run (or the input) io_buffer_size bytes at a time
+template <typename T>
+class RecordReader
+{
+private:
+    std::filesystem::path path;
+    std::ifstream file;
+    std::vector<T> buffer;
+    size_t position;
+    size_t count;
+    size_t remaining;
+    ExternalSortStats &stats;
+
+public:
+    RecordReader(const std::filesystem::path &p, size_t num_records, size_t buffer_records, ExternalSortStats &s)
+        : path(p), file(p, std::ios_base::in | std::ios_base::binary), buffer(std::max<size_t>(1, buffer_records)), position(0), count(0), remaining(num_records), stats(s)
+    {
+        if (!file.is_open())
+        {
+            throw std::runtime_error(path.string() + " failed to open (r)");
+        }
+    }
+
+    // Reads up to max_records into out and returns how many were read
+    size_t Read(T *out, size_t max_records)
+    {
+        size_t n{std::min(max_records, remaining)};
+        if (!file.read(reinterpret_cast<char *>(out), static_cast<std::streamsize>(n * sizeof(T))))
+        {
+            throw std::runtime_error(path.string() + " read failed");
+        }
+        remaining -= n;
+        stats.bytes_read += n * sizeof(T);
+        return n;
+    }
+
+    // Front record, nullptr once the run is used up
+    const T *Front()
+    {
+        if (position == count)
+        {
+            count = Read(buffer.data(), buffer.size());
+            position = 0;
+            if (count == 0)
+            {
+                return nullptr;
+            }
+        }
+        return &buffer[position];
+    }
+
+    const T *Next()
+    {
+        position++;
+        return Front();
+    }
+};
+
+// Writes records io_buffer_size bytes at a time
+template <typename T>
+class RecordWriter
+{
+private:
+    std::filesystem::path path;
+    std::ofstream file;
+    std::vector<T> buffer;
+    size_t count;
+    ExternalSortStats &stats;
+
+public:
+    RecordWriter(const std::filesystem::path &p, size_t buffer_records, ExternalSortStats &s)
+        : path(p), file(p, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc), buffer(std::max<size_t>(1, buffer_records)), count(0), stats(s)
+    {
+        if (!file.is_open())
+        {
+            throw std::runtime_error(path.string() + " failed to open (w)");
+        }
+    }
+
+    // Writes records directly, without going through the buffer
+    void Write(const T *records, size_t n)
+    {
+        if (!file.write(reinterpret_cast<const char *>(records), static_cast<std::streamsize>(n * sizeof(T))))
+        {
+            throw std::runtime_error(path.string() + " write failed");
+        }
+        stats.bytes_written += n * sizeof(T);
+    }
+
+    // Returns true when the buffer was written out (a good time to report progress)
+    bool Push(const T &record)
+    {
+        buffer[count++] = record;
+        if (count == buffer.size())
+        {
+            Flush();
+            return true;
+        }
+        return false;
+    }
+
+    void Flush()
+    {
+        Write(buffer.data(), count);
+        count = 0;
+        if (!file.flush())
+        {
+            throw std::runtime_error(path.string() + " write failed");
+        }
+    }
+
+    /*
+    Flushes and closes the file. The last bytes may only reach the disk (and fail, e.g.
+    when it's full) on close, which the destructor would do without telling anyone.
+    */
+    void Close()
+    {
+        Flush();
+        file.close();
+        if (file.fail())
+        {
+            throw std::runtime_error(path.string() + " close failed");
+        }
+    }
+};
+
+// Run file that deletes itself when it goes out of scope (including when an exception is thrown)
+class TempRunFile
+{
+private:
+    std::filesystem::path path;
+
+public:
+    explicit TempRunFile(std::filesystem::path p) : path(std::move(p)) {}
+    TempRunFile(const TempRunFile &) = delete;
+    TempRunFile &operator=(const TempRunFile &) = delete;
+    TempRunFile(TempRunFile &&other) noexcept : path(std::move(other.path))
+    {
+        other.path.clear();
+    }
+    ~TempRunFile()
+    {
+        if (!path.empty())
+        {
+            std::error_code ignored;
+            std::filesystem::remove(path, ignored);
+        }
+    }
+
+    const std::filesystem::path &Path() const
+    {
+        return path;
+    }
+};
+
+struct SortedRun
+{
+    TempRunFile file;
+    size_t records;
+};
+
+// Merges runs [first, last) into writer with a loser tree
+template <typename T, typename Compare>
+void MergeRuns(std::vector<SortedRun>::const_iterator first, std::vector<SortedRun>::const_iterator last, RecordWriter<T> &writer,
+               size_t buffer_records, Compare comp, ExternalSortStats &stats, const ExternalSortOptions &options)
+{
+    std::vector<RecordReader<T>> readers;
+    std::vector<const T *> fronts;
+    readers.reserve(static_cast<size_t>(last - first));
+    for (auto run = first; run != last; ++run)
+    {
+        readers.emplace_back(run->file.Path(), run->records, buffer_records, stats);
+    }
+    for (auto &reader : readers)
+    {
+        fronts.push_back(reader.Front());
+    }
+    LoserTree<T, Compare> tree(std::move(fronts), comp);
+    auto start{std::chrono::steady_clock::now()};
+    double merge_seconds_before{stats.merge_seconds};
+    while (const T *top = tree.Top())
+    {
+        bool flushed{writer.Push(*top)};
+        tree.ReplaceWinner(readers[tree.Winner()].Next());
+        if (flushed && options.on_progress)
+        {
+            std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+            stats.merge_seconds = merge_seconds_before + elapsed.count();
+            options.on_progress(stats);
+        }
+    }
+    writer.Flush();
+    std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+    stats.merge_seconds = merge_seconds_before + elapsed.count();
+}
+
+/*
+Sorts the records of type T in input into output (which may not be input) with comp, a
+strict weak ordering as for std::sort. Returns the final counters. T must be trivially
+copyable since records are read and written as bytes.
+
+While making runs the budget holds the records being sorted, minus one io buffer for
+writing. Note std::inplace_merge inside ParallelSort may briefly ask for extra memory
+(it falls back to a slower merge when it can't get it). While merging each run gets an
+equal share of the budget as its read buffer, but at least io_buffer_size.
+*/
+template <typename T, typename Compare = std::less<>>
+ExternalSortStats ExternalSort(const std::filesystem::path &input, const std::filesystem::path &output, ExternalSortOptions options = {}, Compare comp = Compare())
+{
+    static_assert(std::is_trivially_copyable_v<T>, "ExternalSort reads and writes records as raw bytes");
+
+    ExternalSortStats stats;
+    std::error_code error;
+    size_t input_bytes{static_cast<size_t>(std::filesystem::file_size(input, error))};
+    if (error)
+    {
+        throw std::runtime_error(input.string() + " failed to open (r)");
+    }
+    if (input_bytes % sizeof(T) != 0)
+    {
+        throw std::runtime_error(input.string() + " size isn't a multiple of the record size");
+    }
+    stats.records = input_bytes / sizeof(T);
+
+    size_t io_records{std::max<size_t>(1, options.io_buffer_size / sizeof(T))};
+    size_t run_records{std::max<size_t>(1, (options.memory_budget - std::min(options.memory_budget, options.io_buffer_size)) / sizeof(T))};
+    // Runs that can be merged at once while each still gets a full io buffer, at least 2 so merging makes progress
+    size_t max_fan_in{std::max<size_t>(2, options.memory_budget / std::max<size_t>(1, options.io_buffer_size) - 1)};
+
+    // A random prefix so sorts running at the same time in the same temp_dir don't collide
+    std::string prefix{"external_sort_" + std::to_string(std::random_device()()) + "_"};
+    size_t next_file{0};
+    auto NewRunPath{[&]
+                    { return options.temp_dir / (prefix + std::to_string(next_file++) + ".run"); }};
+
+    // 1. Runs
+    std::vector<SortedRun> runs;
+    {
+        auto start{std::chrono::steady_clock::now()};
+        RecordReader<T> reader(input, stats.records, 1, stats);
+        std::vector<T> records(std::min(run_records, stats.records));
+        size_t n;
+        while ((n = reader.Read(records.data(), records.size())) > 0)
+        {
+            ParallelSort(records.begin(), records.begin() + n, comp, options.num_threads);
+            runs.push_back({TempRunFile(NewRunPath()), n});
+            RecordWriter<T> writer(runs.back().file.Path(), 1, stats);
+            for (size_t i = 0; i < n; i += io_records)
+            {
+                writer.Write(records.data() + i, std::min(io_records, n - i));
+            }
+            writer.Close();
+            stats.runs++;
+            std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+            stats.run_seconds = elapsed.count();
+            if (options.on_progress)
+            {
+                options.on_progress(stats);
+            }
+        }
+    }
+
+    // 2. Merge groups of max_fan_in runs into longer runs until one final merge is left
+    while (runs.size() > max_fan_in)
+    {
+        std::vector<SortedRun> merged;
+        for (size_t i = 0; i < runs.size(); i += max_fan_in)
+        {
+            size_t group_end{std::min(runs.size(), i + max_fan_in)};
+            size_t records{0};
+            for (size_t j = i; j < group_end; j++)
+            {
+                records += runs[j].records;
+            }
+            merged.push_back({TempRunFile(NewRunPath()), records});
+            RecordWriter<T> writer(merged.back().file.Path(), io_records, stats);
+            MergeRuns(runs.cbegin() + i, runs.cbegin() + group_end, writer, io_records, comp, stats, options);
+            writer.Close();
+        }
+        runs = std::move(merged);
+        stats.extra_merge_passes++;
+    }
+
+    size_t buffer_records{std::max(io_records, options.memory_budget / sizeof(T) / std::max<size_t>(1, runs.size() + 1))};
+    RecordWriter<T> writer(output, io_records, stats);
+    MergeRuns(runs.cbegin(), runs.cend(), writer, buffer_records, comp, stats, options);
+    writer.Close();
+    if (options.on_progress)
+    {
+        options.on_progress(stats);
+    }
+    return stats;
+}
+
+#endif
@@ -0,0 +1,380 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dedup.h"
+#include "parallel.h"
+
+/*
+Counting how often every value occurs (a histogram, or SQL's GROUP BY key COUNT(*)).
+std::count answers "how many 0s" with a pass over the data, so counting every distinct
+value that way would take a pass per value. These count every value in one pass, with
+the input split across threads.
+
+- DenseHistogram is for integer keys in a known, not too big range [low, high] (bytes,
+  small ids, ages): each thread counts into its own array indexed by key - low, then
+  the arrays are added up, with each thread adding up a slice of the keys.
+- SparseHistogram is for keys spread over a huge range (hashes, user ids), where an
+  array with a counter per possible key would be mostly empty. Each thread counts its
+  chunk in hash tables, one per partition of the keys (picked by hash like
+  ParallelHashUniqueCopy in dedup.h), then each thread merges one partition's tables
+  from every chunk, so no table is shared between threads at either step.
+*/
+
+// Key ranges up to this size get DENSE_HISTOGRAM_COPIES interleaved counter arrays per thread
+constexpr size_t DENSE_HISTOGRAM_SMALL_RANGE{1 << 12};
+constexpr size_t DENSE_HISTOGRAM_COPIES{4};
+// Elements EstimateDistinctCount looks at
+constexpr size_t DISTINCT_SAMPLE_SIZE{1 << 12};
+
+/*
+Like OpenAddressingSet (see dedup.h) with a count next to each key. A count of 0 marks an
+empty slot, so no separate used flag is needed.
+*/
+template <typename T, typename Hash = std::hash<T>>
+class CountingHashTable
+{
+private:
+    struct Slot
+    {
+        T key;
+        size_t count;
+    };
+
+    std::vector<Slot> slots;
+    size_t num_keys;
+    unsigned bits;
+    Hash hash;
+
+    size_t SlotIndex(const T &key) const
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(hash(key)) * HASH_MULTIPLIER) >> (64 - bits));
+    }
+
+    void Rehash(unsigned new_bits)
+    {
+        std::vector<Slot> old_slots(std::move(slots));
+        bits = new_bits;
+        slots.assign(size_t{1} << bits, Slot{T(), 0});
+        num_keys = 0;
+        for (const auto &slot : old_slots)
+        {
+            if (slot.count != 0)
+            {
+                Add(slot.key, slot.count);
+            }
+        }
+    }
+
+public:
+    explicit CountingHashTable(size_t expected_size = 0, Hash h = Hash()) : num_keys(0), bits(4), hash(h)
+    {
+        while ((size_t{1} << bits) < 2 * expected_size)
+        {
+            bits++;
+        }
+        slots.assign(size_t{1} << bits, Slot{T(), 0});
+    }
+
+    // Adds count (which must not be 0) to key's count
+    void Add(const T &key, size_t count = 1)
+    {
+        size_t mask{slots.size() - 1};
+        for (size_t i = SlotIndex(key);; i = (i + 1) & mask)
+        {
+            if (slots[i].count == 0)
+            {
+                // Only a new key can push the table past 3/4 full
+                if (4 * (num_keys + 1) > 3 * slots.size())
+                {
+                    Rehash(bits + 1);
+                    Add(key, count);
+                    return;
+                }
+                slots[i] = Slot{key, count};
+                num_keys++;
+                return;
+            }
+            if (slots[i].key == key)
+            {
+                slots[i].count += count;
+                return;
+            }
+        }
+    }
+
+    // Count of key, 0 if it was never added
+    size_t Count(const T &key) const
+    {
+        size_t mask{slots.size() - 1};
+        for (size_t i = SlotIndex(key); slots[i].count != 0; i = (i + 1) & mask)
+        {
+            if (slots[i].key == key)
+            {
+                return slots[i].count;
+            }
+        }
+        return 0;
+    }
+
+    void Prefetch(const T &key) const
+    {
+        __builtin_prefetch(&slots[SlotIndex(key)]);
+    }
+
+    // Adds every key and count of other
+    void Merge(const CountingHashTable &other)
+    {
+        for (const auto &slot : other.slots)
+        {
+            if (slot.count != 0)
+            {
+                Add(slot.key, slot.count);
+            }
+        }
+    }
+
+    // Number of distinct keys
+    size_t size() const
+    {
+        return num_keys;
+    }
+
+    // Writes the (key, count) pairs to out in no particular order, returns the end of the output
+    template <typename OutputIt>
+    OutputIt CopyTo(OutputIt out) const
+    {
+        for (const auto &slot : slots)
+        {
+            if (slot.count != 0)
+            {
+                *out = std::pair<T, size_t>(slot.key, slot.count);
+                ++out;
+            }
+        }
+        return out;
+    }
+};
+
+/*
+Counts [begin, end) of first into counts[key - low] for keys in [low, low + range). Keys
+outside the range are skipped: subtracting as unsigned wraps keys below low around to
+huge indices, so one comparison catches both sides.
+
+When the same key comes up again soon (few distinct keys, or runs of equal keys), each
+increment has to wait for the previous one to the same counter to finish. For small
+ranges, counting consecutive elements into DENSE_HISTOGRAM_COPIES separate arrays lets
+those increments overlap, and the copies are added up at the end.
+*/
+template <typename RandomIt, typename T>
+void CountDenseChunk(RandomIt first, size_t begin, size_t end, T low, size_t range, size_t *counts)
+{
+    using U = std::make_unsigned_t<T>;
+    if (range > DENSE_HISTOGRAM_SMALL_RANGE)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            size_t index{static_cast<U>(static_cast<U>(first[i]) - static_cast<U>(low))};
+            if (index < range)
+            {
+                counts[index]++;
+            }
+        }
+        return;
+    }
+
+    std::vector<size_t> copies(DENSE_HISTOGRAM_COPIES * range, 0);
+    size_t i{begin};
+    for (; i + DENSE_HISTOGRAM_COPIES <= end; i += DENSE_HISTOGRAM_COPIES)
+    {
+        for (size_t copy = 0; copy < DENSE_HISTOGRAM_COPIES; copy++)
+        {
+            size_t index{static_cast<U>(static_cast<U>(first[i + copy]) - static_cast<U>(low))};
+            if (index < range)
+            {
+                copies[copy * range + index]++;
+            }
+        }
+    }
+    for (; i < end; i++)
+    {
+        size_t index{static_cast<U>(static_cast<U>(first[i]) - static_cast<U>(low))};
+        if (index < range)
+        {
+            copies[index]++;
+        }
+    }
+    for (size_t copy = 0; copy < DENSE_HISTOGRAM_COPIES; copy++)
+    {
+        for (size_t index = 0; index < range; index++)
+        {
+            counts[index] += copies[copy * range + index];
+        }
+    }
+}
+
+/*
+Returns counts where counts[k - low] is the number of elements equal to k, for every
+integer k in [low, high]. Elements outside [low, high] aren't counted. Each thread
+needs high - low + 1 counters, so for wide ranges with few elements use SparseHistogram.
+low and high have the element type (not their own, which for literals is int), so wide
+keys are never narrowed to fit them before the range check.
+*/
+template <typename RandomIt>
+std::vector<size_t> DenseHistogram(RandomIt first, RandomIt last, std::iter_value_t<RandomIt> low, std::iter_value_t<RandomIt> high, unsigned num_threads = DefaultThreadCount())
+{
+    using T = std::iter_value_t<RandomIt>;
+    static_assert(std::is_integral_v<T>, "DenseHistogram indexes counters by key, so keys must be integers");
+    using U = std::make_unsigned_t<T>;
+    if (high < low)
+    {
+        return {};
+    }
+    size_t range{static_cast<size_t>(static_cast<U>(static_cast<U>(high) - static_cast<U>(low))) + 1};
+    size_t n{static_cast<size_t>(last - first)};
+    std::vector<size_t> counts(range, 0);
+    unsigned num_chunks{ChunkCount(n, num_threads)};
+    if (num_chunks == 1)
+    {
+        CountDenseChunk(first, 0, n, low, range, counts.data());
+        return counts;
+    }
+
+    // Each thread allocates (and so first touches) its own counters
+    std::vector<std::vector<size_t>> chunk_counts(num_chunks);
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        chunk_counts[chunk].assign(range, 0);
+        CountDenseChunk(first, begin, end, low, range, chunk_counts[chunk].data()); });
+    ParallelChunks(range, ChunkCount(range, num_threads), [&](unsigned, size_t begin, size_t end)
+                   {
+        for (const auto &chunk : chunk_counts)
+        {
+            for (size_t index = begin; index < end; index++)
+            {
+                counts[index] += chunk[index];
+            }
+        } });
+    return counts;
+}
+
+/*
+Guesses the number of distinct elements in [first, first + n) from DISTINCT_SAMPLE_SIZE
+evenly spaced ones, so SparseHistogram can size its tables up front instead of growing
+them (which rehashes every key each time). If there are D equally likely keys, about
+s^2 / (2D) of the pairs in a sample of s are equal (the birthday problem), so D is
+estimated from the number of equal pairs. It's only a size hint, a bad guess costs
+some memory or some growing, not a wrong count.
+*/
+template <typename RandomIt, typename Hash>
+size_t EstimateDistinctCount(RandomIt first, size_t n, Hash hash)
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    if (n <= DISTINCT_SAMPLE_SIZE)
+    {
+        return n;
+    }
+    CountingHashTable<T, Hash> sample(DISTINCT_SAMPLE_SIZE, hash);
+    for (size_t i = 0; i < DISTINCT_SAMPLE_SIZE; i++)
+    {
+        sample.Add(first[i * (n / DISTINCT_SAMPLE_SIZE)]);
+    }
+    std::vector<std::pair<T, size_t>> counts(sample.size());
+    sample.CopyTo(counts.begin());
+    size_t equal_pairs{0};
+    for (const auto &[key, count] : counts)
+    {
+        equal_pairs += count * (count - 1) / 2;
+    }
+    if (equal_pairs == 0)
+    {
+        return n;
+    }
+    size_t estimate{DISTINCT_SAMPLE_SIZE * (DISTINCT_SAMPLE_SIZE - 1) / (2 * equal_pairs)};
+    return std::clamp(estimate, sample.size(), n);
+}
+
+/*
+Returns a (key, count) pair for every distinct element, in no particular order (sort it
+if the order matters). Works for any key type with a hash and ==, like
+std::unordered_map<T, size_t> but without a node allocation per key.
+*/
+template <typename RandomIt, typename T = typename std::iterator_traits<RandomIt>::value_type, typename Hash = std::hash<T>>
+std::vector<std::pair<T, size_t>> SparseHistogram(RandomIt first, RandomIt last, unsigned num_threads = DefaultThreadCount(), Hash hash = Hash())
+{
+    size_t n{static_cast<size_t>(last - first)};
+    unsigned num_chunks{ChunkCount(n, num_threads)};
+    size_t distinct{EstimateDistinctCount(first, n, hash)};
+    if (num_chunks == 1)
+    {
+        CountingHashTable<T, Hash> table(distinct, hash);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (i + DEDUP_PREFETCH_DISTANCE < n)
+            {
+                table.Prefetch(first[i + DEDUP_PREFETCH_DISTANCE]);
+            }
+            table.Add(first[i]);
+        }
+        std::vector<std::pair<T, size_t>> result(table.size());
+        table.CopyTo(result.begin());
+        return result;
+    }
+
+    // Partition of a key, the top 32 bits of its mixed hash scaled to [0, num_chunks)
+    auto Partition{[&](const T &key)
+                   {
+        uint64_t mixed{static_cast<uint64_t>(hash(key)) * PARTITION_MULTIPLIER};
+        return static_cast<size_t>(((mixed >> 32) * num_chunks) >> 32); }};
+
+    // tables[chunk][partition], a chunk has at most as many distinct keys as elements
+    std::vector<std::vector<CountingHashTable<T, Hash>>> tables(num_chunks);
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        tables[chunk].assign(num_chunks, CountingHashTable<T, Hash>(std::min(distinct, end - begin) / num_chunks, hash));
+        for (size_t i = begin; i < end; i++)
+        {
+            tables[chunk][Partition(first[i])].Add(first[i]);
+        } });
+
+    // Each partition's tables merged into the biggest one, which saves growing it again
+    std::vector<CountingHashTable<T, Hash> *> merged(num_chunks);
+    ParallelChunks(n, num_chunks, [&](unsigned partition, size_t, size_t)
+                   {
+        unsigned biggest{0};
+        for (unsigned chunk = 1; chunk < num_chunks; chunk++)
+        {
+            if (tables[chunk][partition].size() > tables[biggest][partition].size())
+            {
+                biggest = chunk;
+            }
+        }
+        for (unsigned chunk = 0; chunk < num_chunks; chunk++)
+        {
+            if (chunk != biggest)
+            {
+                tables[biggest][partition].Merge(tables[chunk][partition]);
+            }
+        }
+        merged[partition] = &tables[biggest][partition]; });
+
+    std::vector<size_t> offsets(num_chunks + 1, 0);
+    for (unsigned partition = 0; partition < num_chunks; partition++)
+    {
+        offsets[partition + 1] = offsets[partition] + merged[partition]->size();
+    }
+    std::vector<std::pair<T, size_t>> result(offsets.back());
+    ParallelChunks(n, num_chunks, [&](unsigned partition, size_t, size_t)
+                   { merged[partition]->CopyTo(result.begin() + offsets[partition]); });
+    return result;
+}
+
+#endif
@@ -8,16 +8,25 @@
 #include <functional>
 #include <cctype>
 
-template <typename T>
-void DisplayContainer(const T &container)
-{
-    std::cout << "[ ";
-    for (auto itr = container.cbegin(); itr != container.cend(); itr++)
-    {
-        std::cout << *itr << " ";
-    }
-    std::cout << "] size = " << container.size() << std::endl;
-}
+#include "../Common/display.h"
+#include "parallel.h"
+#include "simd.h"
+#include "radix_sort.h"
+#include "static_index.h"
+#include "compact.h"
+#include "philox.h"
+#include "searchers.h"
+#include "statistics.h"
+#include "pipeline.h"
+#include "top_k.h"
+#include "scan.h"
+#include "dedup.h"
+#include "external_sort.h"
+#include "adaptive_sort.h"
+#include "sorting_network.h"
+#include "histogram.h"
+#include "bulk_memory.h"
+#include "set_operations.h"
 
 template <typename T>
 struct RangeCounter
@@ -102,6 +111,11 @@ int main()
     // Note fill modifies the vector, needs non const iterators (readonly - use const)
     std::fill(vec4.begin(), vec4.end(), 1);
     DisplayContainer(vec4);
+    // For buffers of many MB, BulkFill and BulkCopy (see bulk_memory.h) bypass the cache and use every core, for 5 elements they're plain fill and copy
+    std::vector<int> vec39(vec4.size());
+    BulkFill(vec39.begin(), vec39.end(), 2);
+    BulkCopy(vec4.cbegin(), vec4.cbegin() + 2, vec39.begin());
+    DisplayContainer(vec39);
 
     /*
     time(NULL) returns current time in seconds: https://cplusplus.com/reference/ctime/time/
@@ -124,6 +138,10 @@ int main()
     RangeCounter<int> counter;
     // Can also supply a class that overrides (), this can be used to collect data on range
     std::for_each(vec6.cbegin(), vec6.cend(), counter);
+    // This prints 0! for_each takes counter by value, so it counts with a copy (see statistics.h)
+    std::cout << counter.count << std::endl;
+    // for_each returns its copy though, so keep that instead
+    counter = std::for_each(vec6.cbegin(), vec6.cend(), counter);
     std::cout << counter.count << std::endl;
 
     std::vector<int> vec7(vec6.size());
@@ -149,6 +167,17 @@ int main()
     DisplayContainer(vec6);
     DisplayContainer(vec8);
     DisplayContainer(vec9);
+    // Both transforms in one loop with no vec7 in between, nothing runs until ToVector (see pipeline.h)
+    std::vector<int> vec29{Lazy(vec6).Map([](int e)
+                                          { return -e; })
+                               .Zip(vec8, std::plus<int>())
+                               .ToVector()};
+    DisplayContainer(vec29);
+    // Sum of the odd elements of vec9, without building a vector of them
+    std::cout << Lazy(vec9).Filter([](int e)
+                                   { return e % 2 != 0; })
+                     .Sum()
+              << std::endl;
 
     // To see transform's use with strings see Characters_and_Strings
 
@@ -164,6 +193,19 @@ int main()
     std::copy_if(ls3.cbegin(), ls3.cend(), vec11.begin(), is_even);
     DisplayContainer(vec11);
 
+    // Prefix sums: each output element is the sum of the input up to and including it (see scan.h)
+    std::vector<int> vec32{3, 1, 4, 1, 5};
+    std::vector<int> vec33(vec32.size());
+    ParallelInclusiveScan(vec32.cbegin(), vec32.cend(), vec33.begin());
+    DisplayContainer(vec33);
+    // Exclusive leaves out the element itself, e.g. where arrays of these sizes start when put back to back
+    ParallelExclusiveScan(vec32.cbegin(), vec32.cend(), vec33.begin(), 0);
+    DisplayContainer(vec33);
+    // Segmented: the sum starts over wherever the flag is set
+    std::vector<char> flags1{1, 0, 1, 0, 0};
+    ParallelSegmentedInclusiveScan(vec32.cbegin(), vec32.cend(), flags1.cbegin(), vec33.begin());
+    DisplayContainer(vec33);
+
     std::vector<int> vec12{1, 2, 2, 3};
     // remove modifies the range, must be non-const iterators
     auto new_end{std::remove(vec12.begin(), vec12.end(), 2)};
@@ -201,6 +243,31 @@ int main()
     std::sort(vec16.begin(), vec16.end(), std::greater<int>());
     DisplayContainer(vec16);
 
+    // Nearly sorted input, as data often arrives, is where the adaptive sorts (see adaptive_sort.h) are fastest
+    std::vector<int> vec37{1, 2, 3, 5, 8, 13, 21, 4, 0};
+    PdqSort(vec37.begin(), vec37.end(), std::greater<int>());
+    DisplayContainer(vec37);
+    // PowerSort is stable like stable_sort, so the descending run is reversed back into ascending order with one pass
+    PowerSort(vec37.begin(), vec37.end());
+    DisplayContainer(vec37);
+    // Tiny arrays whose size is known at compile time sort fastest with a fixed sorting network (see sorting_network.h)
+    std::vector<int> vec38{3, 1, 4, 2, 3};
+    SortN<5>(vec38.begin());
+    DisplayContainer(vec38);
+    // -0.0 and 0.0 compare equal, a sort still has to keep one of each rather than two of either
+    std::vector<float> vec43{0.0f, -0.0f, 1.5f, -0.0f, 0.0f};
+    SortN<5>(vec43.begin());
+    DisplayContainer(vec43);
+
+    // If only the first few are needed, there's no need to sort everything (see top_k.h)
+    std::vector<int> vec31{3, 1, 4, 2, 3};
+    auto top_end{SelectTopK(vec31.begin(), vec31.end(), 2, std::greater<int>())};
+    // 2 largest in order, the rest are left in no particular order
+    std::cout << *vec31.begin() << " " << *(top_end - 1) << std::endl;
+    // Leaves the range alone, only ever holds 2 elements
+    DisplayContainer(TopK(vec16.cbegin(), vec16.cend(), 2));
+    DisplayContainer(ParallelTopK(vec16.cbegin(), vec16.cend(), 2, std::greater<int>()));
+
     // Can use unique to remove adjacent duplicates (useful after a sort)
     new_end = std::unique(vec15.begin(), vec15.end());
     // Note that, like remove doesn't actually remove, moves duplicates to the end
@@ -215,6 +282,13 @@ int main()
     new_end = std::unique(vec17.begin(), vec17.end());
     DisplayContainer(vec17);
     std::cout << std::boolalpha << (new_end == vec17.end()) << std::endl;
+    // HashUnique (see dedup.h) removes all of the duplicates without sorting, keeping the first 3 where it was
+    std::vector<int> vec34{3, 1, 4, 3, 2};
+    vec34.erase(HashUnique(vec34.begin(), vec34.end()), vec34.end());
+    DisplayContainer(vec34);
+    std::vector<int> vec35(vec17.size());
+    vec35.erase(ParallelHashUniqueCopy(vec17.cbegin(), vec17.cend(), vec35.begin()), vec35.end());
+    DisplayContainer(vec35);
 
     // also supplies bool binary search
     std::cout << std::binary_search(vec15.cbegin(), vec15.cend(), 3) << " " << std::binary_search(vec15.cbegin(), vec15.cend(), 5) << std::endl;
@@ -240,5 +314,159 @@ int main()
     // This means we can add a 3 by inserting at 2, 3, or 4 (before or after at either of existing 3s)
     std::cout << std::distance(vec19.cbegin(), min_pos) << " " << std::distance(vec19.cbegin(), max_pos) << std::endl;
 
+    /*
+    Sorted ranges can also be combined without searching for each element, see
+    set_operations.h. These take sets (no repeats, so not vec19) and gallop through the
+    bigger range when the sizes are lopsided. MergeJoin pairs up elements with equal keys,
+    repeats included.
+    */
+    std::vector<int> vec40{1, 2, 3, 6}, vec41{2, 3, 4, 5, 6, 7};
+    std::vector<int> vec42(vec41.size() + vec40.size());
+    vec42.erase(SortedIntersection(vec40.cbegin(), vec40.cend(), vec41.cbegin(), vec41.cend(), vec42.begin()), vec42.end());
+    DisplayContainer(vec42);
+    vec42.resize(vec40.size());
+    vec42.erase(SortedDifference(vec40.cbegin(), vec40.cend(), vec41.cbegin(), vec41.cend(), vec42.begin()), vec42.end());
+    DisplayContainer(vec42);
+    std::vector<std::pair<int, char>> grades{{1, 'A'}, {2, 'C'}, {2, 'B'}, {4, 'A'}};
+    std::vector<std::pair<int, std::string>> names{{1, "Ann"}, {2, "Bob"}, {3, "Cy"}};
+    std::vector<std::pair<std::pair<int, char>, std::pair<int, std::string>>> joined;
+    auto id{[](const auto &p)
+            { return p.first; }};
+    MergeJoin(grades.cbegin(), grades.cend(), names.cbegin(), names.cend(), std::back_inserter(joined), id, id);
+    for (const auto &[grade, name] : joined)
+    {
+        std::cout << name.second << ": " << grade.second << " ";
+    }
+    std::cout << std::endl;
+
+    /*
+    Parallel versions (see parallel.h) take the same predicates and functors as above plus
+    an optional thread count. They only split the work across threads for big ranges
+    (see PARALLEL_GRAIN_SIZE), so on these small vectors they just run sequentially.
+    */
+    std::vector<int> vec20{2017, 0, -1, 42, 10101, 25, 9, 9, 9};
+    std::cout << *ParallelFindIf(vec20.cbegin(), vec20.cend(), is_even) << " " << ParallelCountIf(vec20.cbegin(), vec20.cend(), is_even) << std::endl;
+    std::vector<int> vec21(vec20.size());
+    ParallelTransform(vec20.cbegin(), vec20.cend(), vec21.begin(), [](int e)
+                      { return -e; });
+    DisplayContainer(vec21);
+    ParallelSort(vec21.begin(), vec21.end(), std::greater<int>());
+    DisplayContainer(vec21);
+    auto split{ParallelPartition(vec20.begin(), vec20.end(), is_even)};
+    std::cout << std::distance(vec20.begin(), split) << " even elements moved to the front" << std::endl;
+    // Stable version keeps 0 before 42 and the odd elements in their original order
+    std::vector<int> vec30{2017, 0, -1, 42, 10101, 25, 9, 9, 9};
+    auto stable_split{ParallelStablePartition(vec30.begin(), vec30.end(), is_even)};
+    std::cout << std::distance(vec30.begin(), stable_split) << " ";
+    DisplayContainer(vec30);
+    ParallelReplaceIf(vec20.begin(), vec20.end(), is_even, 0);
+    DisplayContainer(vec20);
+
+    /*
+    SIMD versions of count, count_if and find (see simd.h) work on the vector's underlying
+    array (data()) and return counts/indices. is_even can't be passed as a lambda, it
+    has to be written as a mask: e is even when (e & 1) == 0.
+    */
+    std::cout << "Using " << SimdLevelName(ActiveSimdLevel()) << std::endl;
+    std::cout << "0 count: " << SimdCount(vec2.data(), vec2.size(), 0) << std::endl;
+    std::cout << "even count: " << SimdCountMasked(vec2.data(), vec2.size(), 1, 0) << std::endl;
+    std::cout << "-1 at index " << SimdFind(vec1.data(), vec1.size(), -1) << std::endl;
+
+    // Radix sort (see radix_sort.h) sorts integers without comparing them, pass true for descending
+    std::vector<int> vec22{3, 1, 4, 2, 3, -5};
+    RadixSort(vec22.begin(), vec22.end());
+    DisplayContainer(vec22);
+    RadixSort(vec22.begin(), vec22.end(), true);
+    DisplayContainer(vec22);
+    // Keys can carry a payload with them, here each key's original index
+    std::vector<int> vec23{30, 10, 20};
+    std::vector<int> vec24{0, 1, 2};
+    RadixSortByKey(vec23.begin(), vec23.end(), vec24.begin());
+    DisplayContainer(vec24);
+
+    /*
+    For many searches on a big sorted vector, build a StaticSortedIndex (see static_index.h)
+    once. It returns the same positions as the lower_bound/upper_bound calls on vec19 above.
+    */
+    StaticSortedIndex<int> index19(vec19);
+    std::cout << index19.LowerBound(3) << " " << index19.UpperBound(3) << " " << index19.Contains(5) << std::endl;
+
+    // remove + erase and unique + erase in one call each (see compact.h), these return the new size
+    std::vector<int> vec25{1, 2, 2, 3};
+    SimdRemove(vec25, 2);
+    DisplayContainer(vec25);
+    std::vector<int> vec26{1, 1, 2, 3, 3, 3};
+    // Passing true also gives back the memory of the erased elements
+    SimdUnique(vec26, true);
+    DisplayContainer(vec26);
+    // Even elements of vec20 (e & 1 == 0)
+    DisplayContainer(SimdCopyIfMasked(vec20, 1, 0));
+
+    /*
+    rand() has one hidden global state, see philox.h for a generator without one. A
+    PhiloxEngine can be passed to generate in place of rand (generate copies it), and
+    PhiloxFillInts fills a range using all threads. The same seed always gives the same
+    numbers, however many threads are used.
+    */
+    std::vector<unsigned> vec27(5);
+    std::generate(vec27.begin(), vec27.end(), PhiloxEngine(time(NULL)));
+    DisplayContainer(vec27);
+    std::vector<int> vec28(5);
+    // Dice rolls
+    PhiloxFillInts(vec28.data(), vec28.size(), 1, 6, 2022);
+    DisplayContainer(vec28);
+    // How often each face came up, all in one pass rather than a count per face (see histogram.h)
+    DisplayContainer(DenseHistogram(vec28.cbegin(), vec28.cend(), 1, 6));
+    // For keys from a big range, like vec3's, the counts come back as (key, count) pairs in no particular order
+    auto counts1{SparseHistogram(vec3.cbegin(), vec3.cend())};
+    std::sort(counts1.begin(), counts1.end());
+    for (const auto &[key, count] : counts1)
+    {
+        std::cout << key << ":" << count << " ";
+    }
+    std::cout << std::endl;
+
+    /*
+    Searchers (see searchers.h) learn what they need about the needle once, then can be used
+    on many haystacks, either called directly or passed to search in place of the needle.
+    */
+    HorspoolSearcher<int> searcher1(ls1.cbegin(), ls1.cend());
+    TwoWaySearcher<int> searcher2(ls1.cbegin(), ls1.cend());
+    std::cout << std::distance(vec3.cbegin(), std::search(vec3.cbegin(), vec3.cend(), searcher1)) << " "
+              << std::distance(vec3.cbegin(), searcher2(vec3.cbegin(), vec3.cend()).first) << std::endl;
+    std::cout << std::distance(vec3.cbegin(), RunSearchN(vec3.cbegin(), vec3.cend(), 3, 9)) << std::endl;
+
+    // StatisticsAccumulator (see statistics.h) collects more than a count, here with 4 histogram buckets over [0, 100)
+    auto stats1{std::for_each(vec6.cbegin(), vec6.cend(), StatisticsAccumulator<int>(0, 100, 4)).Result()};
+    std::cout << stats1.count << " " << stats1.min << " " << stats1.max << " " << stats1.mean << " " << stats1.StandardDeviation() << std::endl;
+    DisplayContainer(stats1.buckets);
+    // Same thing with one accumulator per thread, merged at the end
+    auto stats2{ParallelStatistics(vec6.cbegin(), vec6.cend(), StatisticsAccumulator<int>(0, 100, 4))};
+    std::cout << stats2.mean << " " << stats2.overflow << std::endl;
+
+    /*
+    Data too big for memory can be sorted in a file (see external_sort.h). Here a budget
+    of 16 bytes (4 ints) forces vec6 into several sorted runs that are merged back.
+    */
+    std::filesystem::path unsorted_path{std::filesystem::temp_directory_path() / "vec6.bin"};
+    std::filesystem::path sorted_path{std::filesystem::temp_directory_path() / "vec6_sorted.bin"};
+    {
+        std::ofstream unsorted_file(unsorted_path, std::ios_base::binary);
+        unsorted_file.write(reinterpret_cast<const char *>(vec6.data()), vec6.size() * sizeof(int));
+    }
+    ExternalSortOptions sort_options;
+    sort_options.memory_budget = 4 * sizeof(int);
+    sort_options.io_buffer_size = sizeof(int);
+    auto sort_stats{ExternalSort<int>(unsorted_path, sorted_path, sort_options)};
+    std::vector<int> vec36(vec6.size());
+    {
+        std::ifstream sorted_file(sorted_path, std::ios_base::binary);
+        sorted_file.read(reinterpret_cast<char *>(vec36.data()), vec36.size() * sizeof(int));
+    }
+    DisplayContainer(vec36);
+    std::cout << sort_stats.runs << " " << sort_stats.extra_merge_passes << std::endl;
+    std::filesystem::remove(unsorted_path);
+    std::filesystem::remove(sorted_path);
+
     return 0;
 }
@@ -0,0 +1,524 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+Multithreaded versions of the <algorithm> calls demonstrated in main.cpp.
+
+The standard library does have execution policies (std::execution::par and
+par_unseq, see: https://en.cppreference.com/w/cpp/algorithm/execution_policy_tag_t)
+but GCC's implementation needs Intel TBB to be installed and linked, which MinGW
+doesn't ship with. So here the range is split into one contiguous chunk per thread
+and each chunk is handed to the sequential std:: algorithm on a std::thread. Each
+function takes the same predicates and functors as its std:: counterpart plus
+the number of threads to use.
+
+These only work with random access iterators (e.g. vector, deque, arrays) because
+the chunk boundaries are found with + n (see discussion in Lists).
+*/
+
+// Below this many elements per thread, starting a thread costs more than it saves
+constexpr size_t PARALLEL_GRAIN_SIZE{1 << 14};
+
+// hardware_concurrency() is allowed to return 0 if it can't tell
+inline unsigned DefaultThreadCount()
+{
+    unsigned n{std::thread::hardware_concurrency()};
+    return n == 0 ? 1 : n;
+}
+
+// Number of chunks to actually use for n elements so no chunk is smaller than the grain size
+inline unsigned ChunkCount(size_t n, unsigned num_threads)
+{
+    size_t max_chunks{std::max<size_t>(1, n / PARALLEL_GRAIN_SIZE)};
+    return static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(num_threads, max_chunks)));
+}
+
+// Start of chunk i when [0, n) is split into num_chunks nearly equal pieces
+inline size_t ChunkBegin(size_t n, unsigned num_chunks, unsigned i)
+{
+    return n / num_chunks * i + std::min<size_t>(i, n % num_chunks);
+}
+
+/*
+Calls f(chunk, begin, end) for every chunk of [0, n), each on its own thread. The
+calling thread runs chunk 0 itself instead of sitting idle in join(). An exception
+escaping f on a worker thread calls std::terminate, so f shouldn't throw.
+*/
+template <typename Function>
+void ParallelChunks(size_t n, unsigned num_chunks, Function f)
+{
+    if (num_chunks <= 1)
+    {
+        f(0u, size_t{0}, n);
+        return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(num_chunks - 1);
+    for (unsigned i = 1; i < num_chunks; i++)
+    {
+        threads.emplace_back(f, i, ChunkBegin(n, num_chunks, i), ChunkBegin(n, num_chunks, i + 1));
+    }
+    f(0u, size_t{0}, ChunkBegin(n, num_chunks, 1));
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+/*
+Like for_each, which returns (a copy of) the functor it was given, so that results
+collected by the functor can be read back. Here each chunk gets its own copy of f (a
+shard) so threads never write to the same functor, and the shards are combined at the
+end with f.Merge(other_shard), which Function must have (see StatisticsAccumulator).
+*/
+template <typename RandomIt, typename Function>
+Function ParallelForEach(RandomIt first, RandomIt last, Function f, unsigned num_threads = DefaultThreadCount())
+{
+    size_t n{static_cast<size_t>(last - first)};
+    unsigned num_chunks{ChunkCount(n, num_threads)};
+    std::vector<Function> shards(num_chunks, f);
+    // for_each works on its own copy (local to the thread) and returns it, so shards are only written once at the end
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   { shards[chunk] = std::for_each(first + begin, first + end, std::move(shards[chunk])); });
+    for (unsigned i = 1; i < num_chunks; i++)
+    {
+        shards[0].Merge(shards[i]);
+    }
+    return shards[0];
+}
+
+/*
+Like find_if, returns the first element satisfying pred (not just any one). Chunks
+scan in small blocks and give up once an earlier chunk has found a match, so a
+match near the front doesn't wait for the whole range to be scanned.
+*/
+template <typename RandomIt, typename UnaryPredicate>
+RandomIt ParallelFindIf(RandomIt first, RandomIt last, UnaryPredicate pred, unsigned num_threads = DefaultThreadCount())
+{
+    size_t n{static_cast<size_t>(last - first)};
+    std::atomic<size_t> found{n};
+    ParallelChunks(n, ChunkCount(n, num_threads), [&](unsigned, size_t begin, size_t end)
+                   {
+        constexpr size_t BLOCK{4096};
+        for (size_t block = begin; block < end && block < found.load(std::memory_order_relaxed); block += BLOCK)
+        {
+            auto block_end{first + std::min(end, block + BLOCK)};
+            auto itr{std::find_if(first + block, block_end, pred)};
+            if (itr != block_end)
+            {
+                // Keep the smallest index if several chunks find something
+                size_t index{static_cast<size_t>(itr - first)};
+                size_t current{found.load()};
+                while (index < current && !found.compare_exchange_weak(current, index))
+                {
+                }
+                return;
+            }
+        } });
+    return first + found.load();
+}
+
+template <typename RandomIt, typename T>
+RandomIt ParallelFind(RandomIt first, RandomIt last, const T &value, unsigned num_threads = DefaultThreadCount())
+{
+    return ParallelFindIf(first, last, [&value](const auto &e)
+                          { return e == value; }, num_threads);
+}
+
+// Each chunk counts into its own slot, which are summed at the end (no shared counter to fight over)
+template <typename RandomIt, typename UnaryPredicate>
+typename std::iterator_traits<RandomIt>::difference_type ParallelCountIf(RandomIt first, RandomIt last, UnaryPredicate pred, unsigned num_threads = DefaultThreadCount())
+{
+    using Count = typename std::iterator_traits<RandomIt>::difference_type;
+    size_t n{static_cast<size_t>(last - first)};
+    unsigned num_chunks{ChunkCount(n, num_threads)};
+    std::vector<Count> counts(num_chunks);
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   { counts[chunk] = std::count_if(first + begin, first + end, pred); });
+    Count total{0};
+    for (Count count : counts)
+    {
+        total += count;
+    }
+    return total;
+}
+
+template <typename RandomIt, typename T>
+typename std::iterator_traits<RandomIt>::difference_type ParallelCount(RandomIt first, RandomIt last, const T &value, unsigned num_threads = DefaultThreadCount())
+{
+    return ParallelCountIf(first, last, [&value](const auto &e)
+                           { return e == value; }, num_threads);
+}
+
+// Unary transform, destination must also be random access so each chunk knows where to write
+template <typename RandomIt, typename OutRandomIt, typename UnaryOperation>
+OutRandomIt ParallelTransform(RandomIt first, RandomIt last, OutRandomIt d_first, UnaryOperation op, unsigned num_threads = DefaultThreadCount())
+{
+    size_t n{static_cast<size_t>(last - first)};
+    ParallelChunks(n, ChunkCount(n, num_threads), [&](unsigned, size_t begin, size_t end)
+                   { std::transform(first + begin, first + end, d_first + begin, op); });
+    return d_first + n;
+}
+
+// Binary transform (e.g. with std::plus<int>())
+template <typename RandomIt1, typename RandomIt2, typename OutRandomIt, typename BinaryOperation>
+OutRandomIt ParallelTransform(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, OutRandomIt d_first, BinaryOperation op, unsigned num_threads = DefaultThreadCount())
+{
+    size_t n{static_cast<size_t>(last1 - first1)};
+    ParallelChunks(n, ChunkCount(n, num_threads), [&](unsigned, size_t begin, size_t end)
+                   { std::transform(first1 + begin, first1 + end, first2 + begin, d_first + begin, op); });
+    return d_first + n;
+}
+
+template <typename RandomIt, typename UnaryPredicate, typename T>
+void ParallelReplaceIf(RandomIt first, RandomIt last, UnaryPredicate pred, const T &new_value, unsigned num_threads = DefaultThreadCount())
+{
+    size_t n{static_cast<size_t>(last - first)};
+    ParallelChunks(n, ChunkCount(n, num_threads), [&](unsigned, size_t begin, size_t end)
+                   { std::replace_if(first + begin, first + end, pred, new_value); });
+}
+
+/*
+Each chunk is sorted on its own thread, then neighbouring sorted chunks are merged
+pairwise (in parallel) until one sorted range is left, like a bottom up merge sort.
+Note the last merge only runs on one thread, so this scales well up to a few cores
+rather than perfectly. comp has the same requirements as for std::sort (strict weak
+ordering), so std::greater<int>() works for descending order.
+*/
+template <typename RandomIt, typename Compare = std::less<>>
+void ParallelSort(RandomIt first, RandomIt last, Compare comp = Compare(), unsigned num_threads = DefaultThreadCount())
+{
+    size_t n{static_cast<size_t>(last - first)};
+    unsigned num_chunks{ChunkCount(n, num_threads)};
+    std::vector<size_t> bounds(num_chunks + 1);
+    for (unsigned i = 0; i <= num_chunks; i++)
+    {
+        bounds[i] = ChunkBegin(n, num_chunks, i);
+    }
+    ParallelChunks(n, num_chunks, [&](unsigned, size_t begin, size_t end)
+                   { std::sort(first + begin, first + end, comp); });
+    for (size_t width = 1; width < num_chunks; width *= 2)
+    {
+        // Merge runs [i, i + width) and [i + width, i + 2 * width) of chunks
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i + width < num_chunks; i += 2 * width)
+        {
+            auto begin{first + bounds[i]};
+            auto middle{first + bounds[i + width]};
+            auto end{first + bounds[std::min<size_t>(i + 2 * width, num_chunks)]};
+            threads.emplace_back([=]
+                                 { std::inplace_merge(begin, middle, end, comp); });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
+
+/*
+Same result as std::partition, but with fewer mispredicted branches (from BlockQuicksort,
+see: https://arxiv.org/abs/1604.06697). std::partition branches on pred for every element,
+which on random data guesses wrong about half the time. Here pred is evaluated for a
+block of 64 elements at each end, writing down the offsets of the misplaced ones without
+branching on the result, and then those are swapped pairwise. The last < 2 blocks are
+left to std::partition. pred may be called more than once per element so it must not
+have side effects.
+*/
+template <typename RandomIt, typename UnaryPredicate>
+RandomIt BlockPartition(RandomIt first, RandomIt last, UnaryPredicate pred)
+{
+    constexpr size_t BLOCK{64};
+    unsigned char offsets_left[BLOCK], offsets_right[BLOCK];
+    // Misplaced elements found in the current left/right block and not swapped yet
+    size_t num_left{0}, num_right{0}, start_left{0}, start_right{0};
+    while (static_cast<size_t>(last - first) > 2 * BLOCK)
+    {
+        if (num_left == 0)
+        {
+            start_left = 0;
+            for (size_t i = 0; i < BLOCK; i++)
+            {
+                offsets_left[num_left] = static_cast<unsigned char>(i);
+                num_left += !pred(first[i]);
+            }
+        }
+        if (num_right == 0)
+        {
+            start_right = 0;
+            for (size_t i = 0; i < BLOCK; i++)
+            {
+                offsets_right[num_right] = static_cast<unsigned char>(i);
+                num_right += pred(*(last - 1 - i));
+            }
+        }
+        size_t num_swaps{std::min(num_left, num_right)};
+        for (size_t k = 0; k < num_swaps; k++)
+        {
+            std::iter_swap(first + offsets_left[start_left + k], last - 1 - offsets_right[start_right + k]);
+        }
+        num_left -= num_swaps;
+        num_right -= num_swaps;
+        start_left += num_swaps;
+        start_right += num_swaps;
+        // A block only moves out of [first, last) once all of its misplaced elements are fixed
+        if (num_left == 0)
+        {
+            first += BLOCK;
+        }
+        if (num_right == 0)
+        {
+            last -= BLOCK;
+        }
+    }
+    return std::partition(first, last, pred);
+}
+
+/*
+Like std::partition, moves elements satisfying pred to the front and returns the
+start of the second group (order within groups isn't kept).
+
+Each chunk is partitioned (with BlockPartition) on its own thread. After that, if t elements satisfy pred
+in total, the only elements in the wrong place are the false ones in [0, t) and the
+true ones in [t, n), and there are exactly as many of each. Those are found from the
+chunk split points and swapped with each other, again split across threads.
+*/
+template <typename RandomIt, typename UnaryPredicate>
+RandomIt ParallelPartition(RandomIt first, RandomIt last, UnaryPredicate pred, unsigned num_threads = DefaultThreadCount())
+{
+    size_t n{static_cast<size_t>(last - first)};
+    unsigned num_chunks{ChunkCount(n, num_threads)};
+    if (num_chunks == 1)
+    {
+        return BlockPartition(first, last, pred);
+    }
+    std::vector<size_t> begins(num_chunks), splits(num_chunks), ends(num_chunks);
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        begins[chunk] = begin;
+        ends[chunk] = end;
+        splits[chunk] = static_cast<size_t>(BlockPartition(first + begin, first + end, pred) - first); });
+
+    size_t split{0};
+    for (unsigned i = 0; i < num_chunks; i++)
+    {
+        split += splits[i] - begins[i];
+    }
+
+    // Intervals (as [begin, end) index pairs) of false elements left of split and true elements right of it
+    std::vector<std::pair<size_t, size_t>> misplaced_false, misplaced_true;
+    size_t num_misplaced{0};
+    for (unsigned i = 0; i < num_chunks; i++)
+    {
+        size_t false_end{std::min(ends[i], split)};
+        if (splits[i] < false_end)
+        {
+            misplaced_false.emplace_back(splits[i], false_end);
+            num_misplaced += false_end - splits[i];
+        }
+        size_t true_begin{std::max(begins[i], split)};
+        if (true_begin < splits[i])
+        {
+            misplaced_true.emplace_back(true_begin, splits[i]);
+        }
+    }
+
+    // Walks the k-th misplaced element onwards through a list of intervals
+    struct IntervalCursor
+    {
+        const std::vector<std::pair<size_t, size_t>> &intervals;
+        size_t interval;
+        size_t position;
+        IntervalCursor(const std::vector<std::pair<size_t, size_t>> &iv, size_t k) : intervals(iv), interval(0), position(0)
+        {
+            while (k >= intervals[interval].second - intervals[interval].first)
+            {
+                k -= intervals[interval].second - intervals[interval].first;
+                interval++;
+            }
+            position = intervals[interval].first + k;
+        }
+        size_t Next()
+        {
+            size_t current{position++};
+            if (position == intervals[interval].second && interval + 1 < intervals.size())
+            {
+                position = intervals[++interval].first;
+            }
+            return current;
+        }
+    };
+
+    ParallelChunks(num_misplaced, ChunkCount(num_misplaced, num_threads), [&](unsigned, size_t begin, size_t end)
+                   {
+        if (begin == end)
+        {
+            return;
+        }
+        IntervalCursor left(misplaced_false, begin), right(misplaced_true, begin);
+        for (size_t k = begin; k < end; k++)
+        {
+            std::iter_swap(first + left.Next(), first + right.Next());
+        } });
+    return first + split;
+}
+
+// Like std::reverse, with the swaps split across threads
+template <typename RandomIt>
+void ParallelReverse(RandomIt first, RandomIt last, unsigned num_threads = DefaultThreadCount())
+{
+    size_t half{static_cast<size_t>(last - first) / 2};
+    ParallelChunks(half, ChunkCount(half, num_threads), [&](unsigned, size_t begin, size_t end)
+                   {
+        for (size_t i = begin; i < end; i++)
+        {
+            std::iter_swap(first + i, last - 1 - i);
+        } });
+}
+
+// Like std::rotate (without the return value), as three reverses since each of those splits evenly across threads
+template <typename RandomIt>
+void ParallelRotate(RandomIt first, RandomIt middle, RandomIt last, unsigned num_threads = DefaultThreadCount())
+{
+    if (ChunkCount(static_cast<size_t>(last - first), num_threads) == 1)
+    {
+        std::rotate(first, middle, last);
+        return;
+    }
+    ParallelReverse(first, middle, num_threads);
+    ParallelReverse(middle, last, num_threads);
+    ParallelReverse(first, last, num_threads);
+}
+
+// Default scratch space (in elements, per thread) for ParallelStablePartition
+constexpr size_t STABLE_PARTITION_BUFFER_SIZE{1 << 16};
+
+/*
+Pieces of a range that are each partitioned (as [begin, split) true and [split, end)
+false), are combined by swapping the false part of one piece with the true part of the
+next: [T1 F1][T2 F2] becomes [T1 T2][F1 F2], which keeps both groups in order. Neighbours
+are combined in pairs, halving the number of pieces each round, so every element is
+rotated about log2(pieces) times. rotate(first, middle, last) does the swapping.
+*/
+struct PartitionedPiece
+{
+    size_t begin;
+    size_t split;
+    size_t end;
+};
+
+template <typename Rotate>
+size_t CombinePartitionedPieces(std::vector<PartitionedPiece> pieces, Rotate rotate)
+{
+    while (pieces.size() > 1)
+    {
+        std::vector<PartitionedPiece> combined;
+        for (size_t i = 0; i + 1 < pieces.size(); i += 2)
+        {
+            const auto &left{pieces[i]};
+            const auto &right{pieces[i + 1]};
+            rotate(left.split, right.begin, right.split);
+            combined.push_back({left.begin, left.split + (right.split - right.begin), right.end});
+        }
+        if (pieces.size() % 2 == 1)
+        {
+            combined.push_back(pieces.back());
+        }
+        pieces = std::move(combined);
+    }
+    return pieces.empty() ? 0 : pieces[0].split;
+}
+
+/*
+std::stable_partition on one thread using at most buffer_size elements of extra space
+(std::stable_partition asks for a buffer as big as the range). Each block of
+buffer_size elements is partitioned by sliding the true elements down in place and
+setting the false ones aside in the buffer, then copying them back after. The blocks
+are then combined with rotations. Returns the split point like std::stable_partition.
+*/
+template <typename RandomIt, typename UnaryPredicate>
+RandomIt BufferedStablePartition(RandomIt first, RandomIt last, UnaryPredicate pred, size_t buffer_size = STABLE_PARTITION_BUFFER_SIZE)
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    size_t n{static_cast<size_t>(last - first)};
+    buffer_size = std::max<size_t>(1, std::min(buffer_size, n));
+    std::vector<T> buffer;
+    buffer.reserve(buffer_size);
+    std::vector<PartitionedPiece> pieces;
+    for (size_t begin = 0; begin < n; begin += buffer_size)
+    {
+        size_t end{std::min(n, begin + buffer_size)};
+        size_t split{begin};
+        buffer.clear();
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>)
+        {
+            // Cheap to copy, so write every element to both places and only move the right position on
+            buffer.resize(end - begin);
+            size_t num_false{0};
+            for (size_t i = begin; i < end; i++)
+            {
+                T e{first[i]};
+                bool keep{static_cast<bool>(pred(e))};
+                first[split] = e;
+                buffer[num_false] = e;
+                split += keep;
+                num_false += !keep;
+            }
+            buffer.resize(num_false);
+        }
+        else
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                if (pred(first[i]))
+                {
+                    if (split != i)
+                    {
+                        first[split] = std::move(first[i]);
+                    }
+                    split++;
+                }
+                else
+                {
+                    buffer.push_back(std::move(first[i]));
+                }
+            }
+        }
+        std::move(buffer.begin(), buffer.end(), first + split);
+        pieces.push_back({begin, split, end});
+    }
+    return first + CombinePartitionedPieces(std::move(pieces), [&](size_t a, size_t b, size_t c)
+                                            { std::rotate(first + a, first + b, first + c); });
+}
+
+/*
+Like std::stable_partition, moves elements satisfying pred to the front keeping their
+order within each group, and returns the start of the second group. Each chunk is
+stable partitioned on its own thread with BufferedStablePartition, so at most
+buffer_size extra elements are used per thread, then the chunks are combined with
+rotations that are themselves split across threads (ParallelRotate). Slower than
+ParallelPartition since elements move more than once.
+*/
+template <typename RandomIt, typename UnaryPredicate>
+RandomIt ParallelStablePartition(RandomIt first, RandomIt last, UnaryPredicate pred, unsigned num_threads = DefaultThreadCount(),
+                                 size_t buffer_size = STABLE_PARTITION_BUFFER_SIZE)
+{
+    size_t n{static_cast<size_t>(last - first)};
+    unsigned num_chunks{ChunkCount(n, num_threads)};
+    std::vector<PartitionedPiece> pieces(num_chunks);
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   { pieces[chunk] = {begin, static_cast<size_t>(BufferedStablePartition(first + begin, first + end, pred, buffer_size) - first), end}; });
+    return first + CombinePartitionedPieces(std::move(pieces), [&](size_t a, size_t b, size_t c)
+                                            { ParallelRotate(first + a, first + b, first + c, num_threads); });
+}
+
+#endif
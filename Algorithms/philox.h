@@ -0,0 +1,298 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "parallel.h"
+#include "simd.h"
+
+/*
+Counter based random numbers to replace srand/rand in std::generate.
+
+rand() keeps one hidden global state that every call updates, so calls from
+different threads fight over it (or are locked), the sequence depends on the order
+of the calls, and a shard of a big buffer can't be regenerated on its own.
+
+Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3",
+https://www.thesalmons.org/john/random123/papers/random123sc11.pdf) has no state to
+update: it scrambles a 128 bit counter with a 64 bit key (the seed) through 10 rounds
+of multiplies and xors, giving 4 random 32 bit words per counter value. Word i of the
+stream for a seed is word i % 4 of block(i / 4, seed), so any part of the stream can
+be computed directly. That makes the parallel fills below produce exactly the same
+numbers for a seed however many threads run them, and lets a shard be reproduced from
+(seed, offset).
+*/
+
+constexpr uint32_t PHILOX_M0{0xD2511F53};
+constexpr uint32_t PHILOX_M1{0xCD9E8D57};
+// Added to the key every round (golden ratio and sqrt(3) - 1 in fixed point)
+constexpr uint32_t PHILOX_W0{0x9E3779B9};
+constexpr uint32_t PHILOX_W1{0xBB67AE85};
+
+// The 4 words for one 128 bit counter value
+inline std::array<uint32_t, 4> PhiloxBlock(std::array<uint32_t, 4> counter, uint64_t seed)
+{
+    uint32_t k0{static_cast<uint32_t>(seed)};
+    uint32_t k1{static_cast<uint32_t>(seed >> 32)};
+    for (int round = 0; round < 10; round++)
+    {
+        uint64_t product0{uint64_t{PHILOX_M0} * counter[0]};
+        uint64_t product1{uint64_t{PHILOX_M1} * counter[2]};
+        counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ k0, static_cast<uint32_t>(product1),
+                   static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ k1, static_cast<uint32_t>(product0)};
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    return counter;
+}
+
+// Block number block of the stream for seed (the upper half of the counter is always 0)
+inline std::array<uint32_t, 4> PhiloxBlock(uint64_t block, uint64_t seed)
+{
+    return PhiloxBlock(std::array<uint32_t, 4>{static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), 0, 0}, seed);
+}
+
+/*
+Same stream wrapped up as a UniformRandomBitGenerator (see:
+https://en.cppreference.com/w/cpp/named_req/UniformRandomBitGenerator), so it can be
+passed to std::generate in place of rand or to the <random> distributions. Unlike rand
+each engine has its own state, so one per thread doesn't need any locking.
+*/
+class PhiloxEngine
+{
+private:
+    uint64_t seed;
+    uint64_t position;
+    std::array<uint32_t, 4> block;
+
+public:
+    using result_type = uint32_t;
+
+    // offset is the word of the stream to start at, e.g. the first element of a shard
+    explicit PhiloxEngine(uint64_t s, uint64_t offset = 0) : seed(s), position(offset), block(PhiloxBlock(offset / 4, s)) {}
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()()
+    {
+        if (position % 4 == 0)
+        {
+            block = PhiloxBlock(position / 4, seed);
+        }
+        return block[position++ % 4];
+    }
+
+    // Skipping ahead is just moving the counter
+    void discard(uint64_t n)
+    {
+        position += n;
+        block = PhiloxBlock(position / 4, seed);
+    }
+};
+
+/*
+Word r scaled into [min, max] by taking the top 32 bits of r * (max - min + 1), which
+avoids %'s division (Lemire, https://arxiv.org/abs/1805.10941). Without a rejection
+step the results are biased by at most (max - min + 1) / 2^32, which keeps word i
+mapped to element i (needed for the same output on any number of threads).
+*/
+inline int PhiloxToInt(uint32_t r, int min, uint64_t range)
+{
+    return static_cast<int>(static_cast<uint32_t>(min) + static_cast<uint32_t>((r * range) >> 32));
+}
+
+/*
+Two words made into a double in [0, 1): 52 random bits become the mantissa of a double
+in [1, 2), then 1 is subtracted. This is done with bit operations (not a conversion)
+so the AVX2 version can match it exactly.
+*/
+inline double PhiloxToDouble(uint32_t high, uint32_t low)
+{
+    uint64_t bits{((uint64_t{high} << 32 | low) >> 12) | 0x3FF0000000000000};
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d - 1.0;
+}
+
+#ifdef SIMD_X86
+
+/*
+Runs 4 Philox blocks at once. Each vector holds one word of 4 consecutive blocks, one per
+64 bit lane (in the low half), because _mm256_mul_epu32 multiplies the low 32 bits of each
+64 bit lane into a full 64 bit product, which is exactly the multiply each round needs.
+*/
+__attribute__((target("avx2"))) inline void AVX2PhiloxBlocks(uint64_t first_block, uint64_t seed, __m256i words[4])
+{
+    const __m256i low_half{_mm256_set1_epi64x(0xFFFFFFFF)};
+    const __m256i m0{_mm256_set1_epi64x(PHILOX_M0)};
+    const __m256i m1{_mm256_set1_epi64x(PHILOX_M1)};
+    __m256i blocks{_mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(first_block)), _mm256_setr_epi64x(0, 1, 2, 3))};
+    __m256i c0{_mm256_and_si256(blocks, low_half)};
+    __m256i c1{_mm256_srli_epi64(blocks, 32)};
+    __m256i c2{_mm256_setzero_si256()};
+    __m256i c3{_mm256_setzero_si256()};
+    uint32_t k0{static_cast<uint32_t>(seed)};
+    uint32_t k1{static_cast<uint32_t>(seed >> 32)};
+    for (int round = 0; round < 10; round++)
+    {
+        __m256i product0{_mm256_mul_epu32(c0, m0)};
+        __m256i product1{_mm256_mul_epu32(c2, m1)};
+        c0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product1, 32), c1), _mm256_set1_epi64x(k0));
+        c1 = _mm256_and_si256(product1, low_half);
+        c2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product0, 32), c3), _mm256_set1_epi64x(k1));
+        c3 = _mm256_and_si256(product0, low_half);
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    words[0] = c0;
+    words[1] = c1;
+    words[2] = c2;
+    words[3] = c3;
+}
+
+// 4 blocks' words (one word per vector) rearranged into stream order and stored as 16 ints
+__attribute__((target("avx2"))) inline void AVX2StoreBlocks(int *out, const __m256i words[4])
+{
+    // Pairs (w0, w1) and (w2, w3) of each block in a 64 bit lane
+    __m256i w01{_mm256_or_si256(words[0], _mm256_slli_epi64(words[1], 32))};
+    __m256i w23{_mm256_or_si256(words[2], _mm256_slli_epi64(words[3], 32))};
+    // unpack works within 128 bit halves, giving blocks 0 and 2, then 1 and 3
+    __m256i blocks02{_mm256_unpacklo_epi64(w01, w23)};
+    __m256i blocks13{_mm256_unpackhi_epi64(w01, w23)};
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_permute2x128_si256(blocks02, blocks13, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 8), _mm256_permute2x128_si256(blocks02, blocks13, 0x31));
+}
+
+__attribute__((target("avx2"))) inline void AVX2PhiloxInts(int *out, uint64_t first_block, uint64_t seed, int min, uint64_t range)
+{
+    __m256i words[4];
+    AVX2PhiloxBlocks(first_block, seed, words);
+    // A range of 2^32 (every int) doesn't fit in the 32 bit multiplier, but then the words are used as they are
+    if (range <= std::numeric_limits<uint32_t>::max())
+    {
+        const __m256i ranges{_mm256_set1_epi64x(static_cast<long long>(range))};
+        for (int w = 0; w < 4; w++)
+        {
+            words[w] = _mm256_srli_epi64(_mm256_mul_epu32(words[w], ranges), 32);
+        }
+    }
+    AVX2StoreBlocks(out, words);
+    __m256i mins{_mm256_set1_epi32(min)};
+    for (int i = 0; i < 16; i += 8)
+    {
+        __m256i *p{reinterpret_cast<__m256i *>(out + i)};
+        _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), mins));
+    }
+}
+
+__attribute__((target("avx2"))) inline void AVX2PhiloxDoubles(double *out, uint64_t first_block, uint64_t seed)
+{
+    __m256i words[4];
+    AVX2PhiloxBlocks(first_block, seed, words);
+    const __m256i one_exponent{_mm256_set1_epi64x(0x3FF0000000000000)};
+    const __m256d ones{_mm256_set1_pd(1.0)};
+    // Each block makes 2 doubles, from words (0, 1) and (2, 3)
+    __m256d first{_mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(_mm256_or_si256(_mm256_slli_epi64(words[0], 32), words[1]), 12), one_exponent)), ones)};
+    __m256d second{_mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(_mm256_or_si256(_mm256_slli_epi64(words[2], 32), words[3]), 12), one_exponent)), ones)};
+    // Interleave so block b's doubles land at 2b and 2b + 1
+    __m256d blocks02{_mm256_unpacklo_pd(first, second)};
+    __m256d blocks13{_mm256_unpackhi_pd(first, second)};
+    _mm256_storeu_pd(out, _mm256_permute2f128_pd(blocks02, blocks13, 0x20));
+    _mm256_storeu_pd(out + 4, _mm256_permute2f128_pd(blocks02, blocks13, 0x31));
+}
+
+#endif
+
+// Elements [begin, end) of the int stream, vectorized in groups of 4 blocks (16 ints) when possible
+inline void PhiloxFillIntsRange(int *data, uint64_t begin, uint64_t end, int min, uint64_t range, uint64_t seed, SimdLevel level)
+{
+    uint64_t i{begin};
+#ifdef SIMD_X86
+    if (std::min(level, ActiveSimdLevel()) >= SimdLevel::AVX2)
+    {
+        for (; i < end && i % 16 != 0; i++)
+        {
+            data[i - begin] = PhiloxToInt(PhiloxBlock(i / 4, seed)[i % 4], min, range);
+        }
+        for (; i + 16 <= end; i += 16)
+        {
+            AVX2PhiloxInts(data + (i - begin), i / 4, seed, min, range);
+        }
+    }
+#endif
+    // One block per 4 ints
+    while (i < end)
+    {
+        auto block{PhiloxBlock(i / 4, seed)};
+        do
+        {
+            data[i - begin] = PhiloxToInt(block[i % 4], min, range);
+            i++;
+        } while (i < end && i % 4 != 0);
+    }
+}
+
+inline void PhiloxFillDoublesRange(double *data, uint64_t begin, uint64_t end, uint64_t seed, SimdLevel level)
+{
+    uint64_t i{begin};
+#ifdef SIMD_X86
+    if (std::min(level, ActiveSimdLevel()) >= SimdLevel::AVX2)
+    {
+        for (; i < end && i % 8 != 0; i++)
+        {
+            auto block{PhiloxBlock(i / 2, seed)};
+            data[i - begin] = PhiloxToDouble(block[i % 2 * 2], block[i % 2 * 2 + 1]);
+        }
+        for (; i + 8 <= end; i += 8)
+        {
+            AVX2PhiloxDoubles(data + (i - begin), i / 2, seed);
+        }
+    }
+#endif
+    // One block per 2 doubles
+    while (i < end)
+    {
+        auto block{PhiloxBlock(i / 2, seed)};
+        do
+        {
+            data[i - begin] = PhiloxToDouble(block[i % 2 * 2], block[i % 2 * 2 + 1]);
+            i++;
+        } while (i < end && i % 2 != 0);
+    }
+}
+
+/*
+Fills data[0, n) with uniform ints in [min, max], split across threads. data[i] is
+always element offset + i of the stream for seed, so the output doesn't depend on
+num_threads or level, and a shard starting at element k of a bigger buffer can be
+regenerated on its own by passing offset = k.
+*/
+inline void PhiloxFillInts(int *data, size_t n, int min, int max, uint64_t seed, uint64_t offset = 0,
+                           unsigned num_threads = DefaultThreadCount(), SimdLevel level = ActiveSimdLevel())
+{
+    uint64_t range{static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1};
+    ParallelChunks(n, ChunkCount(n, num_threads), [&](unsigned, size_t begin, size_t end)
+                   { PhiloxFillIntsRange(data + begin, offset + begin, offset + end, min, range, seed, level); });
+}
+
+// Same for uniform doubles in [0, 1) (each double uses 2 words of the stream)
+inline void PhiloxFillDoubles(double *data, size_t n, uint64_t seed, uint64_t offset = 0,
+                              unsigned num_threads = DefaultThreadCount(), SimdLevel level = ActiveSimdLevel())
+{
+    ParallelChunks(n, ChunkCount(n, num_threads), [&](unsigned, size_t begin, size_t end)
+                   { PhiloxFillDoublesRange(data + begin, offset + begin, offset + end, seed, level); });
+}
+
+#endif
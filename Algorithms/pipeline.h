@@ -0,0 +1,335 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Lazy transform pipelines. Chaining std::transform calls (e.g. negate into vec7, then
+add vec8 into vec9 as main.cpp does) writes out a whole intermediate vector at every
+step, and each step reads back what the previous one wrote. For big vectors that's
+all memory traffic.
+
+Here each step only records what to do (an "expression template", the type of the
+pipeline describes the whole chain), and nothing runs until the end:
+    std::vector<int> out{Lazy(vec6).Map(negate).Zip(vec8, std::plus<int>()).ToVector()};
+which runs one loop computing vec8[i] - vec6[i] for each i, with no intermediate vectors.
+Since the compiler sees the whole chain inside one loop it can inline every step and
+vectorize the loop.
+
+Map and Zip keep element i at position i, so those pipelines can be indexed and are
+written with out[i] = pipeline[i]. Filter doesn't (it drops elements), so after a Filter
+the pipeline pushes elements through the remaining steps one at a time instead.
+
+Pipelines hold pointers to the vectors they read, not copies, so those vectors must
+outlive the pipeline, as with iterators. Functions are copied into the pipeline.
+*/
+
+/*
+Calls sink on each element of expr. Indexed expressions get a plain counted loop, which
+is the shape the vectorizer looks for, the rest (after a Filter) use their Push.
+*/
+template <typename Expr, typename Sink>
+void PushAll(const Expr &expr, Sink &&sink)
+{
+    if constexpr (Expr::indexed)
+    {
+        size_t n{expr.size()};
+        for (size_t i = 0; i < n; i++)
+        {
+            sink(expr[i]);
+        }
+    }
+    else
+    {
+        expr.Push(sink);
+    }
+}
+
+// Elements [data, data + n) of an existing array, the start of every pipeline
+template <typename T>
+class SourceExpr
+{
+private:
+    const T *data;
+    size_t n;
+
+public:
+    using value_type = T;
+    static constexpr bool indexed{true};
+
+    SourceExpr(const T *d, size_t count) : data(d), n(count) {}
+
+    size_t size() const
+    {
+        return n;
+    }
+
+    const T &operator[](size_t i) const
+    {
+        return data[i];
+    }
+};
+
+// f(expr[i])
+template <typename Expr, typename Function>
+class MapExpr
+{
+private:
+    Expr expr;
+    Function f;
+
+public:
+    using value_type = std::decay_t<std::invoke_result_t<const Function &, const typename Expr::value_type &>>;
+    static constexpr bool indexed{Expr::indexed};
+
+    MapExpr(Expr e, Function func) : expr(std::move(e)), f(std::move(func)) {}
+
+    // An upper bound when there is a Filter earlier in the pipeline
+    size_t size() const
+    {
+        return expr.size();
+    }
+
+    value_type operator[](size_t i) const
+    {
+        return f(expr[i]);
+    }
+
+    // Calls sink on each element (see Pipeline::ForEach)
+    template <typename Sink>
+    void Push(Sink &&sink) const
+    {
+        PushAll(expr, [&](const auto &e)
+                { sink(f(e)); });
+    }
+};
+
+// f(left[i], right[i]), stops at the end of the shorter side like a zip in other languages
+template <typename Left, typename Right, typename Function>
+class ZipExpr
+{
+    static_assert(Left::indexed && Right::indexed, "Zip needs both sides to keep element positions (no Filter before it)");
+
+private:
+    Left left;
+    Right right;
+    Function f;
+
+public:
+    using value_type = std::decay_t<std::invoke_result_t<const Function &, const typename Left::value_type &, const typename Right::value_type &>>;
+    static constexpr bool indexed{true};
+
+    ZipExpr(Left l, Right r, Function func) : left(std::move(l)), right(std::move(r)), f(std::move(func)) {}
+
+    size_t size() const
+    {
+        return std::min(left.size(), right.size());
+    }
+
+    value_type operator[](size_t i) const
+    {
+        return f(left[i], right[i]);
+    }
+};
+
+// expr elements satisfying pred, in order
+template <typename Expr, typename Predicate>
+class FilterExpr
+{
+private:
+    Expr expr;
+    Predicate pred;
+
+public:
+    using value_type = typename Expr::value_type;
+    static constexpr bool indexed{false};
+
+    FilterExpr(Expr e, Predicate p) : expr(std::move(e)), pred(std::move(p)) {}
+
+    // Only an upper bound, the real size isn't known until the pipeline runs
+    size_t size() const
+    {
+        return expr.size();
+    }
+
+    template <typename Sink>
+    void Push(Sink &&sink) const
+    {
+        PushAll(expr, [&](const auto &e)
+                {
+            if (pred(e))
+            {
+                sink(e);
+            } });
+    }
+
+    /*
+    When nothing before the Filter drops elements, every element is written to out and
+    the count only moves past the kept ones. That avoids a branch which would be
+    mispredicted about half the time when the predicate is unpredictable.
+    */
+    size_t CopyTo(value_type *out) const
+    {
+        size_t count{0};
+        if constexpr (Expr::indexed)
+        {
+            size_t n{expr.size()};
+            for (size_t i = 0; i < n; i++)
+            {
+                value_type e{expr[i]};
+                out[count] = e;
+                count += pred(e) ? 1 : 0;
+            }
+        }
+        else
+        {
+            Push([&](const value_type &e)
+                 { out[count++] = e; });
+        }
+        return count;
+    }
+};
+
+/*
+Wraps an expression with the methods that extend it (Map, Zip, Filter) and the ones that
+run it (ToVector, CopyTo, Reduce, Sum, Count, ForEach). Start one with Lazy(...).
+*/
+template <typename Expr>
+class Pipeline
+{
+private:
+    Expr expr;
+
+    template <typename>
+    friend class Pipeline;
+
+public:
+    using value_type = typename Expr::value_type;
+
+    explicit Pipeline(Expr e) : expr(std::move(e)) {}
+
+    template <typename Function>
+    auto Map(Function f) const
+    {
+        return Pipeline<MapExpr<Expr, Function>>(MapExpr<Expr, Function>(expr, std::move(f)));
+    }
+
+    template <typename OtherExpr, typename Function>
+    auto Zip(const Pipeline<OtherExpr> &other, Function f) const
+    {
+        return Pipeline<ZipExpr<Expr, OtherExpr, Function>>(ZipExpr<Expr, OtherExpr, Function>(expr, other.expr, std::move(f)));
+    }
+
+    template <typename U, typename Function>
+    auto Zip(const std::vector<U> &other, Function f) const
+    {
+        return Zip(Pipeline<SourceExpr<U>>(SourceExpr<U>(other.data(), other.size())), std::move(f));
+    }
+
+    template <typename Predicate>
+    auto Filter(Predicate pred) const
+    {
+        return Pipeline<FilterExpr<Expr, Predicate>>(FilterExpr<Expr, Predicate>(expr, std::move(pred)));
+    }
+
+    // Upper bound on the number of elements (exact when there is no Filter)
+    size_t size() const
+    {
+        return expr.size();
+    }
+
+    // Element i, only for pipelines without a Filter
+    value_type operator[](size_t i) const
+    {
+        static_assert(Expr::indexed, "Can't index a pipeline after Filter");
+        return expr[i];
+    }
+
+    template <typename Function>
+    void ForEach(Function f) const
+    {
+        PushAll(expr, f);
+    }
+
+    // Writes the elements to out (which needs room for size() elements) and returns how many were written
+    size_t CopyTo(value_type *out) const
+    {
+        if constexpr (Expr::indexed)
+        {
+            size_t n{expr.size()};
+            for (size_t i = 0; i < n; i++)
+            {
+                out[i] = expr[i];
+            }
+            return n;
+        }
+        else if constexpr (requires { expr.CopyTo(out); })
+        {
+            return expr.CopyTo(out);
+        }
+        else
+        {
+            size_t count{0};
+            PushAll(expr, [&](const value_type &e)
+                    { out[count++] = e; });
+            return count;
+        }
+    }
+
+    // The only place a vector gets allocated
+    std::vector<value_type> ToVector() const
+    {
+        std::vector<value_type> vec(expr.size());
+        vec.resize(CopyTo(vec.data()));
+        return vec;
+    }
+
+    // Like std::accumulate(begin, end, init, op)
+    template <typename T, typename BinaryOp = std::plus<>>
+    T Reduce(T init, BinaryOp op = BinaryOp()) const
+    {
+        PushAll(expr, [&](const value_type &e)
+                { init = op(std::move(init), e); });
+        return init;
+    }
+
+    value_type Sum() const
+    {
+        return Reduce(value_type{});
+    }
+
+    size_t Count() const
+    {
+        if constexpr (Expr::indexed)
+        {
+            return expr.size();
+        }
+        else
+        {
+            return Reduce(size_t{0}, [](size_t count, const value_type &)
+                          { return count + 1; });
+        }
+    }
+};
+
+template <typename T>
+Pipeline<SourceExpr<T>> Lazy(const std::vector<T> &vec)
+{
+    return Pipeline<SourceExpr<T>>(SourceExpr<T>(vec.data(), vec.size()));
+}
+
+// Contiguous iterators only (vector, array, string), see the Lists discussion of why lists aren't
+template <typename ContiguousIt>
+auto Lazy(ContiguousIt first, ContiguousIt last)
+{
+    using T = std::remove_const_t<std::remove_reference_t<decltype(*first)>>;
+    return Pipeline<SourceExpr<T>>(SourceExpr<T>(std::to_address(first), static_cast<size_t>(last - first)));
+}
+
+#endif
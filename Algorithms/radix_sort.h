@@ -0,0 +1,176 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+LSD (least significant digit) radix sort for 32 and 64 bit integer keys, see:
+https://en.wikipedia.org/wiki/Radix_sort#Least_significant_digit
+
+std::sort compares elements, which takes O(n log n) comparisons. Radix sort never
+compares: it does one pass per byte of the key (4 for int, 8 for long long), each
+pass stably distributing the elements into 256 buckets by that byte. So it does
+O(n) work per byte, which beats std::sort once n gets large (see Benchmarks).
+
+Two tricks make the byte order match the integer order:
+- Signed ints store negative numbers with the top bit set (two's complement), so
+  they'd come after the positives. Flipping the sign bit fixes that.
+- For descending order, flipping every bit reverses the order of the keys while the
+  passes stay stable, so equal keys keep their original order either way.
+
+Like std::sort these take iterators, but the iterators must point into contiguous
+memory (vector, array) since the passes work on the underlying arrays.
+*/
+
+// Below this many elements insertion sort is faster than the 4 or 8 passes over the buckets
+constexpr size_t RADIX_INSERTION_SORT_THRESHOLD{64};
+
+// Key with its bits arranged so that comparing them as unsigned gives the wanted order
+template <typename Key>
+std::make_unsigned_t<Key> RadixKey(Key key, bool descending)
+{
+    using Bits = std::make_unsigned_t<Key>;
+    Bits bits{static_cast<Bits>(key)};
+    if constexpr (std::is_signed_v<Key>)
+    {
+        bits ^= Bits{1} << (sizeof(Key) * 8 - 1);
+    }
+    return descending ? static_cast<Bits>(~bits) : bits;
+}
+
+/*
+Sorts keys[0, n) and, when Value isn't void, applies the same moves to values[0, n).
+Stable, so equal keys keep their payloads in their original order.
+*/
+template <typename Key, typename Value>
+void RadixSortArrays(Key *keys, Value *values, size_t n, bool descending)
+{
+    static_assert(std::is_integral_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8), "RadixSort needs 32 or 64 bit integer keys");
+    constexpr bool has_values{!std::is_void_v<Value>};
+
+    if (n < RADIX_INSERTION_SORT_THRESHOLD)
+    {
+        for (size_t i = 1; i < n; i++)
+        {
+            Key key{keys[i]};
+            auto bits{RadixKey(key, descending)};
+            size_t j{i};
+            if constexpr (has_values)
+            {
+                Value value{std::move(values[i])};
+                for (; j > 0 && RadixKey(keys[j - 1], descending) > bits; j--)
+                {
+                    keys[j] = keys[j - 1];
+                    values[j] = std::move(values[j - 1]);
+                }
+                values[j] = std::move(value);
+            }
+            else
+            {
+                for (; j > 0 && RadixKey(keys[j - 1], descending) > bits; j--)
+                {
+                    keys[j] = keys[j - 1];
+                }
+            }
+            keys[j] = key;
+        }
+        return;
+    }
+
+    // One pass to count every byte of every key, instead of one counting pass per byte
+    constexpr size_t num_digits{sizeof(Key)};
+    std::vector<size_t> counts(num_digits * 256);
+    for (size_t i = 0; i < n; i++)
+    {
+        auto bits{RadixKey(keys[i], descending)};
+        for (size_t d = 0; d < num_digits; d++)
+        {
+            counts[d * 256 + ((bits >> (d * 8)) & 0xFF)]++;
+        }
+    }
+
+    std::vector<Key> key_buffer(n);
+    Key *key_src{keys}, *key_dst{key_buffer.data()};
+    // Stays empty (as a vector<char>) when there are no values
+    std::vector<std::conditional_t<has_values, Value, char>> value_buffer;
+    Value *value_src{values}, *value_dst{nullptr};
+    if constexpr (has_values)
+    {
+        value_buffer.resize(n);
+        value_dst = value_buffer.data();
+    }
+
+    for (size_t d = 0; d < num_digits; d++)
+    {
+        size_t *digit_counts{counts.data() + d * 256};
+        // If every key has the same byte here the pass wouldn't move anything (common for small values' top bytes)
+        if (digit_counts[(RadixKey(key_src[0], descending) >> (d * 8)) & 0xFF] == n)
+        {
+            continue;
+        }
+
+        // Turn counts into the index where each bucket starts
+        size_t offset{0};
+        for (size_t b = 0; b < 256; b++)
+        {
+            size_t count{digit_counts[b]};
+            digit_counts[b] = offset;
+            offset += count;
+        }
+
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t to{digit_counts[(RadixKey(key_src[i], descending) >> (d * 8)) & 0xFF]++};
+            key_dst[to] = key_src[i];
+            if constexpr (has_values)
+            {
+                value_dst[to] = std::move(value_src[i]);
+            }
+        }
+        std::swap(key_src, key_dst);
+        if constexpr (has_values)
+        {
+            std::swap(value_src, value_dst);
+        }
+    }
+
+    // After an odd number of passes the sorted data is in the buffers
+    if (key_src != keys)
+    {
+        std::copy(key_src, key_src + n, keys);
+        if constexpr (has_values)
+        {
+            std::move(value_src, value_src + n, values);
+        }
+    }
+}
+
+// Sorts [first, last) ascending (like std::sort) or descending (like std::sort with std::greater)
+template <typename ContiguousIt>
+void RadixSort(ContiguousIt first, ContiguousIt last, bool descending = false)
+{
+    using Key = typename std::iterator_traits<ContiguousIt>::value_type;
+    RadixSortArrays<Key, void>(std::to_address(first), nullptr, static_cast<size_t>(last - first), descending);
+}
+
+/*
+Key plus payload version: sorts [key_first, key_last) and moves the payload starting at
+value_first along with its key, e.g. to sort record ids by age. Sorting the keys and
+values as separate arrays means the passes only read the (small) keys to pick buckets.
+Values must be default constructible and movable.
+*/
+template <typename KeyIt, typename ValueIt>
+void RadixSortByKey(KeyIt key_first, KeyIt key_last, ValueIt value_first, bool descending = false)
+{
+    using Key = typename std::iterator_traits<KeyIt>::value_type;
+    using Value = typename std::iterator_traits<ValueIt>::value_type;
+    RadixSortArrays<Key, Value>(std::to_address(key_first), std::to_address(value_first), static_cast<size_t>(key_last - key_first), descending);
+}
+
+#endif
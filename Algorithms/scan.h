@@ -0,0 +1,387 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "parallel.h"
+#include "simd.h"
+
+/*
+Prefix sums (scans), like std::inclusive_scan and std::exclusive_scan from <numeric>:
+    inclusive: dst[i] = src[0] + ... + src[i]
+    exclusive: dst[i] = init + src[0] + ... + src[i - 1]
+e.g. exclusive scanning the sizes of some arrays gives where each one starts when they
+are laid out back to back, and exclusive scanning keep flags (0 or 1) gives where each
+kept element goes in a stream compaction.
+
+Segmented scans restart the sum wherever flags[i] is nonzero, so each segment is
+scanned on its own (the sums don't carry across segment boundaries):
+    src   = 1 2 3 4 5
+    flags = 1 0 1 0 0
+    inclusive segmented = 1 3 3 7 12
+    exclusive segmented = 0 1 0 3 7
+
+Each element's sum depends on the one before it, which looks impossible to vectorize
+or split across threads, but addition can be regrouped:
+- Inside a vector register the scan takes log2(lanes) shift and add steps (add the
+  vector shifted up 1 lane, then 2 lanes, then 4, ...), then the running total from
+  the previous vector is added to every lane.
+- Across threads, each thread first sums its own chunk, a short scan of those chunk
+  sums gives the total before each chunk, and each thread then scans its chunk
+  starting from that total. That reads the input twice but writes it once.
+
+The SIMD kernels are for int sums (like simd.h, picked at runtime). They wrap around on
+overflow rather than having undefined behaviour like the std:: versions. Other element
+types, or iterators that aren't contiguous, use a plain loop with +, still split across
+threads.
+*/
+
+// a + b, wrapping around on overflow for signed integers (as the vector adds do) instead of being undefined
+template <typename T>
+T WrappingAdd(const T &a, const T &b)
+{
+    if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+    {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+    }
+    else
+    {
+        return a + b;
+    }
+}
+
+// Scans [src, src + n) into dst starting from carry, returns the sum after the last element
+template <bool Exclusive, bool Segmented, typename InputIt, typename FlagIt, typename OutputIt, typename T>
+T ScalarScan(InputIt src, FlagIt flags, size_t n, OutputIt dst, T carry)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        T e(src[i]);
+        if constexpr (Segmented)
+        {
+            carry = flags[i] ? T() : carry;
+        }
+        T previous(carry);
+        carry = WrappingAdd(carry, e);
+        dst[i] = Exclusive ? previous : carry;
+    }
+    return carry;
+}
+
+#ifdef SIMD_X86
+
+/*
+In the shift and add steps of a segmented scan, a lane only adds what is shifted into it
+when no segment starts between the two lanes. heads has all bits set in lanes where a
+segment starts, and after each step it's ORed with itself shifted the same way, so it
+then marks lanes with a segment start anywhere in the distance covered so far. At the
+end it marks lanes with a segment start at or before them in the vector, which are the
+lanes the previous vector's running total doesn't reach.
+
+Exclusive scans compute the inclusive scan and subtract each lane's own element.
+*/
+__attribute__((target("sse2"))) inline __m128i SSE2LoadHeads(const uint8_t *flags)
+{
+    int bytes;
+    std::memcpy(&bytes, flags, sizeof(bytes));
+    __m128i zero{_mm_setzero_si128()};
+    __m128i wide{_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero)};
+    return _mm_xor_si128(_mm_cmpeq_epi32(wide, zero), _mm_set1_epi32(-1));
+}
+
+template <bool Exclusive, bool Segmented>
+__attribute__((target("sse2"))) int SSE2ScanInts(const int *src, const uint8_t *flags, size_t n, int *dst, int carry)
+{
+    __m128i carries{_mm_set1_epi32(carry)};
+    size_t i{0};
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i e{_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))};
+        __m128i v{e};
+        if constexpr (Segmented)
+        {
+            __m128i heads{SSE2LoadHeads(flags + i)};
+            v = _mm_add_epi32(v, _mm_andnot_si128(heads, _mm_slli_si128(v, 4)));
+            heads = _mm_or_si128(heads, _mm_slli_si128(heads, 4));
+            v = _mm_add_epi32(v, _mm_andnot_si128(heads, _mm_slli_si128(v, 8)));
+            heads = _mm_or_si128(heads, _mm_slli_si128(heads, 8));
+            v = _mm_add_epi32(v, _mm_andnot_si128(heads, carries));
+        }
+        else
+        {
+            v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+            v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+            v = _mm_add_epi32(v, carries);
+        }
+        // The last lane is the new running total
+        carries = _mm_shuffle_epi32(v, 0xFF);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), Exclusive ? _mm_sub_epi32(v, e) : v);
+    }
+    return ScalarScan<Exclusive, Segmented>(src + i, Segmented ? flags + i : nullptr, n - i, dst + i, _mm_cvtsi128_si32(carries));
+}
+
+// AVX2 shifts bytes within each 128 bit half, so shifting by k lanes brings in the low half's top lanes with alignr
+template <int Lanes>
+__attribute__((target("avx2"))) inline __m256i AVX2ShiftLanesUp(__m256i v)
+{
+    // Low half moved to the high half, zeros in the low half
+    __m256i low_up{_mm256_permute2x128_si256(v, v, 0x08)};
+    if constexpr (Lanes == 4)
+    {
+        return low_up;
+    }
+    else
+    {
+        return _mm256_alignr_epi8(v, low_up, 16 - 4 * Lanes);
+    }
+}
+
+template <bool Exclusive, bool Segmented>
+__attribute__((target("avx2"))) int AVX2ScanInts(const int *src, const uint8_t *flags, size_t n, int *dst, int carry)
+{
+    __m256i carries{_mm256_set1_epi32(carry)};
+    const __m256i last_lane{_mm256_set1_epi32(7)};
+    size_t i{0};
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i e{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i))};
+        __m256i v{e};
+        if constexpr (Segmented)
+        {
+            __m128i bytes{_mm_loadl_epi64(reinterpret_cast<const __m128i *>(flags + i))};
+            __m256i heads{_mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(bytes), _mm256_setzero_si256()), _mm256_set1_epi32(-1))};
+            v = _mm256_add_epi32(v, _mm256_andnot_si256(heads, AVX2ShiftLanesUp<1>(v)));
+            heads = _mm256_or_si256(heads, AVX2ShiftLanesUp<1>(heads));
+            v = _mm256_add_epi32(v, _mm256_andnot_si256(heads, AVX2ShiftLanesUp<2>(v)));
+            heads = _mm256_or_si256(heads, AVX2ShiftLanesUp<2>(heads));
+            v = _mm256_add_epi32(v, _mm256_andnot_si256(heads, AVX2ShiftLanesUp<4>(v)));
+            heads = _mm256_or_si256(heads, AVX2ShiftLanesUp<4>(heads));
+            v = _mm256_add_epi32(v, _mm256_andnot_si256(heads, carries));
+        }
+        else
+        {
+            v = _mm256_add_epi32(v, AVX2ShiftLanesUp<1>(v));
+            v = _mm256_add_epi32(v, AVX2ShiftLanesUp<2>(v));
+            v = _mm256_add_epi32(v, AVX2ShiftLanesUp<4>(v));
+            v = _mm256_add_epi32(v, carries);
+        }
+        carries = _mm256_permutevar8x32_epi32(v, last_lane);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), Exclusive ? _mm256_sub_epi32(v, e) : v);
+    }
+    return SSE2ScanInts<Exclusive, Segmented>(src + i, Segmented ? flags + i : nullptr, n - i, dst + i, _mm256_extract_epi32(carries, 0));
+}
+
+/*
+AVX-512 has mask registers, so heads is a 16 bit mask and the adds are masked instead of
+ANDed. The maskz_ forms with every lane selected are used in place of the plain
+intrinsics, which make GCC warn about an uninitialized temporary in its headers.
+*/
+template <int Lanes>
+__attribute__((target("avx512f"))) inline __m512i AVX512ShiftLanesUp(__m512i v)
+{
+    return _mm512_maskz_alignr_epi32(0xFFFF, v, _mm512_setzero_si512(), 16 - Lanes);
+}
+
+template <bool Exclusive, bool Segmented>
+__attribute__((target("avx512f"))) int AVX512ScanInts(const int *src, const uint8_t *flags, size_t n, int *dst, int carry)
+{
+    __m512i carries{_mm512_set1_epi32(carry)};
+    const __m512i last_lane{_mm512_set1_epi32(15)};
+    size_t i{0};
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512i e{_mm512_loadu_si512(src + i)};
+        __m512i v{e};
+        if constexpr (Segmented)
+        {
+            __m512i wide{_mm512_maskz_cvtepu8_epi32(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i *>(flags + i)))};
+            __mmask16 heads{_mm512_test_epi32_mask(wide, wide)};
+            v = _mm512_mask_add_epi32(v, static_cast<__mmask16>(~heads), v, AVX512ShiftLanesUp<1>(v));
+            heads = static_cast<__mmask16>(heads | heads << 1);
+            v = _mm512_mask_add_epi32(v, static_cast<__mmask16>(~heads), v, AVX512ShiftLanesUp<2>(v));
+            heads = static_cast<__mmask16>(heads | heads << 2);
+            v = _mm512_mask_add_epi32(v, static_cast<__mmask16>(~heads), v, AVX512ShiftLanesUp<4>(v));
+            heads = static_cast<__mmask16>(heads | heads << 4);
+            v = _mm512_mask_add_epi32(v, static_cast<__mmask16>(~heads), v, AVX512ShiftLanesUp<8>(v));
+            heads = static_cast<__mmask16>(heads | heads << 8);
+            v = _mm512_mask_add_epi32(v, static_cast<__mmask16>(~heads), v, carries);
+        }
+        else
+        {
+            v = _mm512_add_epi32(v, AVX512ShiftLanesUp<1>(v));
+            v = _mm512_add_epi32(v, AVX512ShiftLanesUp<2>(v));
+            v = _mm512_add_epi32(v, AVX512ShiftLanesUp<4>(v));
+            v = _mm512_add_epi32(v, AVX512ShiftLanesUp<8>(v));
+            v = _mm512_add_epi32(v, carries);
+        }
+        carries = _mm512_maskz_permutexvar_epi32(0xFFFF, last_lane, v);
+        _mm512_storeu_si512(dst + i, Exclusive ? _mm512_sub_epi32(v, e) : v);
+    }
+    return AVX2ScanInts<Exclusive, Segmented>(src + i, Segmented ? flags + i : nullptr, n - i, dst + i, _mm512_cvtsi512_si32(carries));
+}
+
+#endif
+
+/*
+Scans src[0, n) into dst (which may be src), starting from carry and returning the sum
+after the last element. flags is only read when Segmented. level works as in simd.h.
+*/
+template <bool Exclusive, bool Segmented>
+int SimdScanInts(const int *src, const uint8_t *flags, size_t n, int *dst, int carry, SimdLevel level = ActiveSimdLevel())
+{
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512ScanInts<Exclusive, Segmented>(src, flags, n, dst, carry);
+    case SimdLevel::AVX2:
+        return AVX2ScanInts<Exclusive, Segmented>(src, flags, n, dst, carry);
+    case SimdLevel::SSE2:
+        return SSE2ScanInts<Exclusive, Segmented>(src, flags, n, dst, carry);
+    default:
+        break;
+    }
+#endif
+    return ScalarScan<Exclusive, Segmented>(src, flags, n, dst, carry);
+}
+
+// Whether a scan can use SimdScanInts: contiguous int input and output, and flags that are bytes (bool, char, uint8_t) or unused (nullptr)
+template <typename InputIt, typename FlagIt, typename OutputIt>
+constexpr bool UseSimdScan()
+{
+    if constexpr (std::contiguous_iterator<InputIt> && std::contiguous_iterator<OutputIt>)
+    {
+        if constexpr (std::is_same_v<std::iter_value_t<InputIt>, int> && std::is_same_v<std::iter_value_t<OutputIt>, int>)
+        {
+            if constexpr (std::is_null_pointer_v<FlagIt>)
+            {
+                return true;
+            }
+            else if constexpr (std::contiguous_iterator<FlagIt>)
+            {
+                return sizeof(std::iter_value_t<FlagIt>) == 1;
+            }
+        }
+    }
+    return false;
+}
+
+template <bool Exclusive, bool Segmented, typename InputIt, typename FlagIt, typename OutputIt, typename T>
+T ScanChunk(InputIt src, FlagIt flags, size_t n, OutputIt dst, T carry)
+{
+    if constexpr (UseSimdScan<InputIt, FlagIt, OutputIt>())
+    {
+        const uint8_t *flag_bytes{nullptr};
+        if constexpr (Segmented)
+        {
+            flag_bytes = reinterpret_cast<const uint8_t *>(std::to_address(flags));
+        }
+        return SimdScanInts<Exclusive, Segmented>(std::to_address(src), flag_bytes, n, std::to_address(dst), carry);
+    }
+    else
+    {
+        return ScalarScan<Exclusive, Segmented>(src, flags, n, dst, carry);
+    }
+}
+
+/*
+The two pass parallel scan behind the functions below. In the first pass each chunk
+works out what it adds to the running sum: its total, or for a segmented scan the sum
+since its last segment start (and whether it has one, since then the sum coming into the
+chunk doesn't get past it).
+*/
+template <bool Exclusive, bool Segmented, typename InputIt, typename FlagIt, typename OutputIt, typename T>
+OutputIt ParallelScan(InputIt first, InputIt last, FlagIt flags, OutputIt d_first, T init, unsigned num_threads)
+{
+    size_t n{static_cast<size_t>(last - first)};
+    unsigned num_chunks{ChunkCount(n, num_threads)};
+    if (num_chunks == 1)
+    {
+        ScanChunk<Exclusive, Segmented>(first, flags, n, d_first, init);
+        return d_first + n;
+    }
+
+    std::vector<T> tails(num_chunks);
+    std::vector<char> has_head(num_chunks, false);
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        size_t sum_from{begin};
+        if constexpr (Segmented)
+        {
+            for (size_t i = end; i > begin; i--)
+            {
+                if (flags[i - 1])
+                {
+                    sum_from = i - 1;
+                    has_head[chunk] = true;
+                    break;
+                }
+            }
+        }
+        T tail{};
+        for (size_t i = sum_from; i < end; i++)
+        {
+            tail = WrappingAdd(tail, T(first[i]));
+        }
+        tails[chunk] = tail; });
+
+    // What the running sum is when each chunk starts
+    std::vector<T> carries(num_chunks);
+    carries[0] = init;
+    for (unsigned i = 1; i < num_chunks; i++)
+    {
+        carries[i] = has_head[i - 1] ? tails[i - 1] : WrappingAdd(carries[i - 1], tails[i - 1]);
+    }
+
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        if constexpr (Segmented)
+        {
+            ScanChunk<Exclusive, Segmented>(first + begin, flags + begin, end - begin, d_first + begin, carries[chunk]);
+        }
+        else
+        {
+            ScanChunk<Exclusive, Segmented>(first + begin, flags, end - begin, d_first + begin, carries[chunk]);
+        } });
+    return d_first + n;
+}
+
+// Like std::inclusive_scan(first, last, d_first), returns the end of the output
+template <typename RandomIt, typename OutputIt>
+OutputIt ParallelInclusiveScan(RandomIt first, RandomIt last, OutputIt d_first, unsigned num_threads = DefaultThreadCount())
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    return ParallelScan<false, false>(first, last, nullptr, d_first, T(), num_threads);
+}
+
+// Like std::exclusive_scan(first, last, d_first, init)
+template <typename RandomIt, typename OutputIt, typename T>
+OutputIt ParallelExclusiveScan(RandomIt first, RandomIt last, OutputIt d_first, T init, unsigned num_threads = DefaultThreadCount())
+{
+    return ParallelScan<true, false>(first, last, nullptr, d_first, static_cast<typename std::iterator_traits<RandomIt>::value_type>(init), num_threads);
+}
+
+// Inclusive scan restarting at every i where flags_first[i] is nonzero (true)
+template <typename RandomIt, typename FlagIt, typename OutputIt>
+OutputIt ParallelSegmentedInclusiveScan(RandomIt first, RandomIt last, FlagIt flags_first, OutputIt d_first, unsigned num_threads = DefaultThreadCount())
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    return ParallelScan<false, true>(first, last, flags_first, d_first, T(), num_threads);
+}
+
+// Exclusive scan restarting at every i where flags_first[i] is nonzero, so the first element of each segment gets 0
+template <typename RandomIt, typename FlagIt, typename OutputIt>
+OutputIt ParallelSegmentedExclusiveScan(RandomIt first, RandomIt last, FlagIt flags_first, OutputIt d_first, unsigned num_threads = DefaultThreadCount())
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    return ParallelScan<true, true>(first, last, flags_first, d_first, T(), num_threads);
+}
+
+#endif
@@ -0,0 +1,324 @@
+#ifndef SEARCHERS_H
+#define SEARCHERS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "simd.h"
+
+/*
+Reusable searchers for std::search and std::search_n over contiguous ranges.
+
+std::search(first, last, needle_first, needle_last) starts over at every position of
+the haystack, so it can do O(n * m) comparisons, and anything it could learn from the
+needle is thrown away after each call. The searchers here do that work once when they
+are built and then run over as many haystacks as needed. Like std::boyer_moore_horspool_searcher
+(see: https://en.cppreference.com/w/cpp/utility/functional/boyer_moore_horspool_searcher)
+they return a pair of iterators to the match, or (last, last) when there isn't one.
+
+Both take the needle's first element and look for it with SimdFind (see simd.h) to skip
+quickly over haystack stretches that can't start a match, which for ints is most of
+them. For other element types (e.g. bytes) a plain std::find is used for that step.
+*/
+
+// Next position in [first, last) holding value, vectorized when T is a 32 bit int
+template <typename T>
+const T *FindFirstElement(const T *first, const T *last, const T &value)
+{
+    if constexpr (std::is_same_v<T, int>)
+    {
+        return first + SimdFind(first, static_cast<size_t>(last - first), value);
+    }
+    else
+    {
+        return std::find(first, last, value);
+    }
+}
+
+/*
+Boyer-Moore-Horspool: compare the needle against the haystack window from its last element
+backwards, and on a mismatch shift the window by how far the window's last element is from
+its last occurrence in the needle (or the whole needle length if it doesn't occur in it).
+The shift table is built once in the constructor. It's a direct array for single bytes and
+a hash map for anything else.
+*/
+template <typename T>
+class HorspoolSearcher
+{
+private:
+    std::vector<T> needle;
+    std::vector<size_t> byte_shifts;
+    std::unordered_map<T, size_t> shifts;
+
+    size_t Shift(const T &e) const
+    {
+        if constexpr (sizeof(T) == 1)
+        {
+            return byte_shifts[static_cast<unsigned char>(e)];
+        }
+        else
+        {
+            auto itr{shifts.find(e)};
+            return itr == shifts.end() ? needle.size() : itr->second;
+        }
+    }
+
+public:
+    template <typename ForwardIt>
+    HorspoolSearcher(ForwardIt first, ForwardIt last) : needle(first, last)
+    {
+        size_t m{needle.size()};
+        if constexpr (sizeof(T) == 1)
+        {
+            byte_shifts.assign(256, m);
+        }
+        // The last needle element isn't included, so a shift is never 0
+        for (size_t i = 0; i + 1 < m; i++)
+        {
+            if constexpr (sizeof(T) == 1)
+            {
+                byte_shifts[static_cast<unsigned char>(needle[i])] = m - 1 - i;
+            }
+            else
+            {
+                shifts[needle[i]] = m - 1 - i;
+            }
+        }
+    }
+
+    template <typename ContiguousIt>
+    std::pair<ContiguousIt, ContiguousIt> operator()(ContiguousIt first, ContiguousIt last) const
+    {
+        size_t m{needle.size()};
+        size_t n{static_cast<size_t>(last - first)};
+        if (m == 0)
+        {
+            return {first, first};
+        }
+        const T *haystack{std::to_address(first)};
+        const T *end{haystack + n};
+        const T *window{haystack};
+        while (static_cast<size_t>(end - window) >= m)
+        {
+            // Jump to the next place the needle's first element appears
+            window = FindFirstElement(window, end - m + 1, needle[0]);
+            if (window == end - m + 1)
+            {
+                break;
+            }
+            size_t i{m - 1};
+            while (i > 0 && window[i] == needle[i])
+            {
+                i--;
+            }
+            if (i == 0)
+            {
+                return {first + (window - haystack), first + (window - haystack) + m};
+            }
+            window += Shift(window[m - 1]);
+        }
+        return {last, last};
+    }
+};
+
+/*
+Two-Way (Crochemore and Perrin, see: https://en.wikipedia.org/wiki/Two-way_string-matching_algorithm
+and the "Two-Way algorithm" page at https://www-igm.univ-mlv.fr/~lecroq/string/node26.html).
+Horspool can still take O(n * m) on repetitive data (e.g. searching for 0 0 0 1 in lots of
+0s), Two-Way is O(n + m) in the worst case with O(1) extra memory. The needle is split at
+its "critical factorization" when the searcher is built, then the right part is matched
+left to right and the left part right to left, shifting by the needle's period when
+possible. Only needs ==, and < to find the factorization.
+*/
+template <typename T>
+class TwoWaySearcher
+{
+private:
+    std::vector<T> needle;
+    size_t split;
+    size_t period;
+    // Whether the needle is periodic with period (then the searcher remembers how much of it matched)
+    bool periodic;
+
+    // Maximal suffix of needle under < (or > when reversed), returns (start, period)
+    std::pair<size_t, size_t> MaximalSuffix(bool reversed) const
+    {
+        size_t m{needle.size()};
+        size_t suffix{0}, j{1}, k{1}, p{1};
+        while (j + k <= m)
+        {
+            const T &a{needle[j + k - 1]};
+            const T &b{needle[suffix + k - 1]};
+            bool less{reversed ? b < a : a < b};
+            if (less)
+            {
+                j += k;
+                k = 1;
+                p = j - suffix;
+            }
+            else if (a == b)
+            {
+                if (k == p)
+                {
+                    j += p;
+                    k = 1;
+                }
+                else
+                {
+                    k++;
+                }
+            }
+            else
+            {
+                suffix = j;
+                j = suffix + 1;
+                k = p = 1;
+            }
+        }
+        return {suffix, p};
+    }
+
+public:
+    template <typename ForwardIt>
+    TwoWaySearcher(ForwardIt first, ForwardIt last) : needle(first, last), split(0), period(1), periodic(false)
+    {
+        size_t m{needle.size()};
+        if (m == 0)
+        {
+            return;
+        }
+        auto [suffix1, period1]{MaximalSuffix(false)};
+        auto [suffix2, period2]{MaximalSuffix(true)};
+        // The critical factorization is the later of the two maximal suffixes
+        if (suffix1 > suffix2)
+        {
+            split = suffix1;
+            period = period1;
+        }
+        else
+        {
+            split = suffix2;
+            period = period2;
+        }
+        // needle[0, split) must occur at needle[period, period + split) for the period to apply to the whole needle
+        periodic = split < m && period + split <= m && std::equal(needle.cbegin(), needle.cbegin() + split, needle.cbegin() + period);
+        if (!periodic)
+        {
+            period = std::max(split, m - split) + 1;
+        }
+    }
+
+    template <typename ContiguousIt>
+    std::pair<ContiguousIt, ContiguousIt> operator()(ContiguousIt first, ContiguousIt last) const
+    {
+        size_t m{needle.size()};
+        size_t n{static_cast<size_t>(last - first)};
+        if (m == 0)
+        {
+            return {first, first};
+        }
+        const T *haystack{std::to_address(first)};
+        size_t pos{0};
+        // Length of the needle prefix already known to match at pos (periodic case only)
+        size_t memory{0};
+        while (pos + m <= n)
+        {
+            // Nothing remembered, so skip ahead to the next place the first element appears
+            if (memory == 0)
+            {
+                const T *next{FindFirstElement(haystack + pos, haystack + n - m + 1, needle[0])};
+                pos = static_cast<size_t>(next - haystack);
+                if (pos + m > n)
+                {
+                    break;
+                }
+            }
+            // Right part, left to right
+            size_t i{std::max(split, memory)};
+            while (i < m && needle[i] == haystack[pos + i])
+            {
+                i++;
+            }
+            if (i < m)
+            {
+                pos += i - split + 1;
+                memory = 0;
+                continue;
+            }
+            // Left part, right to left
+            size_t j{split};
+            while (j > memory && needle[j - 1] == haystack[pos + j - 1])
+            {
+                j--;
+            }
+            if (j <= memory)
+            {
+                return {first + pos, first + pos + m};
+            }
+            pos += period;
+            memory = periodic ? m - period : 0;
+        }
+        return {last, last};
+    }
+};
+
+/*
+search_n for count copies of value in a row. std::search_n can look at every element.
+This checks the element count - 1 past the start of a possible run first: if it isn't
+value, no run of count covering it can start at or before it, so the search jumps past
+it. If it is value, the run is measured backwards and forwards from there, and a run
+that is too short is skipped as a whole. So a search looks at about n / count elements
+when value is rare.
+*/
+template <typename ContiguousIt, typename T>
+ContiguousIt RunSearchN(ContiguousIt first, ContiguousIt last, size_t count, const T &value)
+{
+    size_t n{static_cast<size_t>(last - first)};
+    if (count == 0)
+    {
+        return first;
+    }
+    const auto *data{std::to_address(first)};
+    // Start of the run being tried
+    size_t start{0};
+    while (start + count <= n)
+    {
+        size_t probe{start + count - 1};
+        if (!(data[probe] == value))
+        {
+            start = probe + 1;
+            continue;
+        }
+        // Extend backwards from probe, down to start at most
+        size_t run_begin{probe};
+        while (run_begin > start && data[run_begin - 1] == value)
+        {
+            run_begin--;
+        }
+        if (run_begin == start)
+        {
+            return first + start;
+        }
+        // Elements [run_begin, probe] match, check whether the run carries on far enough
+        size_t run_end{probe + 1};
+        while (run_end < n && run_end - run_begin < count && data[run_end] == value)
+        {
+            run_end++;
+        }
+        if (run_end - run_begin >= count)
+        {
+            return first + run_begin;
+        }
+        // The run stopped short at run_end, no match can include it
+        start = run_end + 1;
+    }
+    return last;
+}
+
+#endif
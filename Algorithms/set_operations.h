@@ -0,0 +1,535 @@
+#ifndef SET_OPERATIONS_H
+#define SET_OPERATIONS_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+#include "simd.h"
+
+/*
+Set operations and a join over sorted ranges, the next step after lower_bound and
+upper_bound on a sorted vector in main.cpp. std::set_intersection and friends always
+merge: they walk both ranges an element at a time, which is the best that can be done
+when the ranges are about the same size, but wasteful when one is much smaller. Finding
+the 1000 elements of a small set in a sorted vector of 10M only needs 1000 searches.
+
+So when one range is more than GALLOP_SIZE_RATIO times the size of the other these
+gallop instead: for each element of the smaller range, search forwards in the bigger one
+from where the last search ended, doubling the step until it overshoots, then binary
+search the last step. That's O(m log(n / m)) compares for m elements against n, and never
+more than about twice a merge. When the sizes are similar, the intersection of int
+ranges compares whole blocks at a time with SIMD (see SimdIntersectInts), the rest use the
+std:: merges.
+
+SortedIntersection, SortedUnion and SortedDifference take sets: each range strictly
+increasing under comp (no two equivalent elements, e.g. after std::unique), and return
+what the std:: versions would. MergeJoin allows repeated keys in both ranges, like a
+database join.
+
+The Parallel versions split the merge into chunks of equal size with merge path (see
+MergePathCoRank) so every thread does the same amount of work however the two ranges
+interleave.
+*/
+
+// When one range is more than this many times bigger than the other, search through it instead of merging
+constexpr size_t GALLOP_SIZE_RATIO{16};
+
+inline bool SizesSkewed(size_t n1, size_t n2)
+{
+    return std::min(n1, n2) * GALLOP_SIZE_RATIO < std::max(n1, n2);
+}
+
+/*
+Like std::partition_point (the first element for which pred is false), but searching
+from first outwards with steps of 1, 2, 4... so it costs O(log d) for an answer d
+elements in, rather than O(log n).
+*/
+template <typename RandomIt, typename Predicate>
+RandomIt GallopPartitionPoint(RandomIt first, RandomIt last, Predicate pred)
+{
+    size_t n{static_cast<size_t>(last - first)};
+    size_t bound{1};
+    while (bound <= n && pred(first[bound - 1]))
+    {
+        bound *= 2;
+    }
+    // pred is true up to first[bound / 2 - 1], and false at first[bound - 1] if that's in range
+    return std::partition_point(first + bound / 2, first + std::min(bound, n), pred);
+}
+
+#ifdef SIMD_X86
+
+/*
+Block intersection kernels, see: https://arxiv.org/abs/1401.6399 (Lemire et al., SIMD
+compression and the intersection of sorted integers). A block of lanes elements from
+each range is compared all against all: lanes compares, each of a against b rotated by
+one more lane. The lanes of a that matched anything are copied out, then the block with
+the smaller last element is replaced by the next one (both, if they're equal). Elements
+of a matched against a later block of b are bigger than everything in the earlier ones,
+so the output stays in order. The rest is finished with std::set_intersection.
+
+Each kernel returns the number of ints written to out.
+*/
+__attribute__((target("sse2"))) inline size_t SSE2IntersectInts(const int *a, size_t n1, const int *b, size_t n2, int *out)
+{
+    size_t i{0};
+    size_t j{0};
+    size_t count{0};
+    while (i + 4 <= n1 && j + 4 <= n2)
+    {
+        __m128i va{_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i))};
+        __m128i vb{_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j))};
+        __m128i eq0{_mm_cmpeq_epi32(va, vb)};
+        __m128i eq1{_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))};
+        __m128i eq2{_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)))};
+        __m128i eq3{_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))};
+        __m128i eq{_mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3))};
+        for (unsigned matched = _mm_movemask_ps(_mm_castsi128_ps(eq)); matched != 0; matched &= matched - 1)
+        {
+            out[count++] = a[i + std::countr_zero(matched)];
+        }
+        int last_a{a[i + 3]};
+        int last_b{b[j + 3]};
+        i += last_a <= last_b ? 4 : 0;
+        j += last_b <= last_a ? 4 : 0;
+    }
+    return count + (std::set_intersection(a + i, a + n1, b + j, b + n2, out + count) - (out + count));
+}
+
+__attribute__((target("avx2"))) inline size_t AVX2IntersectInts(const int *a, size_t n1, const int *b, size_t n2, int *out)
+{
+    __m256i rotations[8];
+    for (int r = 0; r < 8; r++)
+    {
+        rotations[r] = _mm256_setr_epi32(r, (r + 1) % 8, (r + 2) % 8, (r + 3) % 8, (r + 4) % 8, (r + 5) % 8, (r + 6) % 8, (r + 7) % 8);
+    }
+    size_t i{0};
+    size_t j{0};
+    size_t count{0};
+    while (i + 8 <= n1 && j + 8 <= n2)
+    {
+        __m256i va{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i))};
+        __m256i vb{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j))};
+        __m256i eq{_mm256_cmpeq_epi32(va, vb)};
+        for (int r = 1; r < 8; r++)
+        {
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, _mm256_permutevar8x32_epi32(vb, rotations[r])));
+        }
+        for (unsigned matched = _mm256_movemask_ps(_mm256_castsi256_ps(eq)); matched != 0; matched &= matched - 1)
+        {
+            out[count++] = a[i + std::countr_zero(matched)];
+        }
+        int last_a{a[i + 7]};
+        int last_b{b[j + 7]};
+        i += last_a <= last_b ? 8 : 0;
+        j += last_b <= last_a ? 8 : 0;
+    }
+    return count + (std::set_intersection(a + i, a + n1, b + j, b + n2, out + count) - (out + count));
+}
+
+// The compares go straight into a mask register. maskz_ forms as in scan.h
+__attribute__((target("avx512f"))) inline size_t AVX512IntersectInts(const int *a, size_t n1, const int *b, size_t n2, int *out)
+{
+    __m512i rotations[16];
+    for (int r = 0; r < 16; r++)
+    {
+        rotations[r] = _mm512_add_epi32(_mm512_set1_epi32(r), _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+    size_t i{0};
+    size_t j{0};
+    size_t count{0};
+    while (i + 16 <= n1 && j + 16 <= n2)
+    {
+        __m512i va{_mm512_loadu_si512(a + i)};
+        __m512i vb{_mm512_loadu_si512(b + j)};
+        __mmask16 matched{_mm512_cmpeq_epi32_mask(va, vb)};
+        for (int r = 1; r < 16; r++)
+        {
+            // permutexvar only uses the low 4 bits of each index, so r + lane wraps around by itself
+            matched |= _mm512_cmpeq_epi32_mask(va, _mm512_maskz_permutexvar_epi32(0xFFFF, rotations[r], vb));
+        }
+        for (unsigned bits = matched; bits != 0; bits &= bits - 1)
+        {
+            out[count++] = a[i + std::countr_zero(bits)];
+        }
+        int last_a{a[i + 15]};
+        int last_b{b[j + 15]};
+        i += last_a <= last_b ? 16 : 0;
+        j += last_b <= last_a ? 16 : 0;
+    }
+    return count + (std::set_intersection(a + i, a + n1, b + j, b + n2, out + count) - (out + count));
+}
+
+#endif
+
+// Intersection of two strictly increasing int arrays into out (room for min(n1, n2) ints), returns the number written
+inline size_t SimdIntersectInts(const int *a, size_t n1, const int *b, size_t n2, int *out, SimdLevel level = ActiveSimdLevel())
+{
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512IntersectInts(a, n1, b, n2, out);
+    case SimdLevel::AVX2:
+        return AVX2IntersectInts(a, n1, b, n2, out);
+    case SimdLevel::SSE2:
+        return SSE2IntersectInts(a, n1, b, n2, out);
+    default:
+        break;
+    }
+#endif
+    return std::set_intersection(a, a + n1, b, b + n2, out) - out;
+}
+
+// Whether an intersection can use SimdIntersectInts: contiguous ints everywhere, in ascending order
+template <typename InputIt1, typename InputIt2, typename OutputIt, typename Compare>
+constexpr bool UseSimdIntersection()
+{
+    if constexpr (std::contiguous_iterator<InputIt1> && std::contiguous_iterator<InputIt2> && std::contiguous_iterator<OutputIt>)
+    {
+        return std::is_same_v<std::iter_value_t<InputIt1>, int> && std::is_same_v<std::iter_value_t<InputIt2>, int> &&
+               std::is_same_v<std::iter_value_t<OutputIt>, int> &&
+               (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<int>>);
+    }
+    return false;
+}
+
+/*
+Like std::set_intersection on strictly increasing ranges: the elements of range 1 that
+are also in range 2. level works as in simd.h and only matters for int ranges of similar
+sizes.
+*/
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare = std::less<>>
+OutputIt SortedIntersection(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, Compare comp = Compare(), SimdLevel level = ActiveSimdLevel())
+{
+    size_t n1{static_cast<size_t>(last1 - first1)};
+    size_t n2{static_cast<size_t>(last2 - first2)};
+    if (SizesSkewed(n1, n2) && n1 < n2)
+    {
+        for (; first1 != last1; ++first1)
+        {
+            first2 = GallopPartitionPoint(first2, last2, [&](const auto &b)
+                                          { return comp(b, *first1); });
+            if (first2 == last2)
+            {
+                break;
+            }
+            if (!comp(*first1, *first2))
+            {
+                *d_first = *first1;
+                ++d_first;
+            }
+        }
+        return d_first;
+    }
+    if (SizesSkewed(n1, n2))
+    {
+        for (; first2 != last2; ++first2)
+        {
+            first1 = GallopPartitionPoint(first1, last1, [&](const auto &a)
+                                          { return comp(a, *first2); });
+            if (first1 == last1)
+            {
+                break;
+            }
+            if (!comp(*first2, *first1))
+            {
+                *d_first = *first1;
+                ++d_first;
+            }
+        }
+        return d_first;
+    }
+    if constexpr (UseSimdIntersection<RandomIt1, RandomIt2, OutputIt, Compare>())
+    {
+        return d_first + SimdIntersectInts(std::to_address(first1), n1, std::to_address(first2), n2, std::to_address(d_first), level);
+    }
+    else
+    {
+        return std::set_intersection(first1, last1, first2, last2, d_first, comp);
+    }
+}
+
+/*
+Like std::set_union on strictly increasing ranges (an element in both is taken from range
+1). When one range is much bigger, the stretches of it between elements of the other are
+found by galloping and copied in one go.
+*/
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare = std::less<>>
+OutputIt SortedUnion(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, Compare comp = Compare())
+{
+    size_t n1{static_cast<size_t>(last1 - first1)};
+    size_t n2{static_cast<size_t>(last2 - first2)};
+    if (!SizesSkewed(n1, n2))
+    {
+        return std::set_union(first1, last1, first2, last2, d_first, comp);
+    }
+    if (n1 < n2)
+    {
+        for (; first1 != last1; ++first1)
+        {
+            RandomIt2 stop{GallopPartitionPoint(first2, last2, [&](const auto &b)
+                                                { return comp(b, *first1); })};
+            d_first = std::copy(first2, stop, d_first);
+            *d_first = *first1;
+            ++d_first;
+            first2 = stop != last2 && !comp(*first1, *stop) ? stop + 1 : stop;
+        }
+    }
+    else
+    {
+        for (; first2 != last2; ++first2)
+        {
+            RandomIt1 stop{GallopPartitionPoint(first1, last1, [&](const auto &a)
+                                                { return comp(a, *first2); })};
+            d_first = std::copy(first1, stop, d_first);
+            first1 = stop;
+            if (first1 == last1 || comp(*first2, *first1))
+            {
+                *d_first = *first2;
+                ++d_first;
+            }
+        }
+    }
+    d_first = std::copy(first1, last1, d_first);
+    return std::copy(first2, last2, d_first);
+}
+
+// Like std::set_difference on strictly increasing ranges: the elements of range 1 that are not in range 2
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare = std::less<>>
+OutputIt SortedDifference(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, Compare comp = Compare())
+{
+    size_t n1{static_cast<size_t>(last1 - first1)};
+    size_t n2{static_cast<size_t>(last2 - first2)};
+    if (!SizesSkewed(n1, n2))
+    {
+        return std::set_difference(first1, last1, first2, last2, d_first, comp);
+    }
+    if (n1 < n2)
+    {
+        for (; first1 != last1; ++first1)
+        {
+            first2 = GallopPartitionPoint(first2, last2, [&](const auto &b)
+                                          { return comp(b, *first1); });
+            if (first2 == last2 || comp(*first1, *first2))
+            {
+                *d_first = *first1;
+                ++d_first;
+            }
+        }
+        return d_first;
+    }
+    for (; first2 != last2 && first1 != last1; ++first2)
+    {
+        RandomIt1 stop{GallopPartitionPoint(first1, last1, [&](const auto &a)
+                                            { return comp(a, *first2); })};
+        d_first = std::copy(first1, stop, d_first);
+        first1 = stop != last1 && !comp(*first2, *stop) ? stop + 1 : stop;
+    }
+    return std::copy(first1, last1, d_first);
+}
+
+/*
+Sort-merge join: for every pair of an element of range 1 and an element of range 2 with
+equivalent keys, writes std::pair{element 1, element 2} to d_first, so the payloads
+(whatever else the elements hold) come along. Both ranges are sorted by key, key1 and
+key2 get the key out of an element (e.g. [](const auto &p) { return p.first; }) and comp
+compares keys. A key repeated a times in range 1 and b times in range 2 gives a * b
+pairs, in order of range 1 then range 2. When one range is much bigger, the other one's
+keys are looked up in it by galloping.
+*/
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Key1 = std::identity, typename Key2 = std::identity, typename Compare = std::less<>>
+OutputIt MergeJoin(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, Key1 key1 = Key1(), Key2 key2 = Key2(), Compare comp = Compare())
+{
+    using Pair = std::pair<std::iter_value_t<RandomIt1>, std::iter_value_t<RandomIt2>>;
+    bool skewed{SizesSkewed(static_cast<size_t>(last1 - first1), static_cast<size_t>(last2 - first2))};
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(key1(*first1), key2(*first2)))
+        {
+            auto before{[&](const auto &a)
+                        { return comp(key1(a), key2(*first2)); }};
+            first1 = skewed ? GallopPartitionPoint(first1, last1, before) : std::find_if_not(first1, last1, before);
+        }
+        else if (comp(key2(*first2), key1(*first1)))
+        {
+            auto before{[&](const auto &b)
+                        { return comp(key2(b), key1(*first1)); }};
+            first2 = skewed ? GallopPartitionPoint(first2, last2, before) : std::find_if_not(first2, last2, before);
+        }
+        else
+        {
+            RandomIt1 run_end1{std::find_if(first1 + 1, last1, [&](const auto &a)
+                                            { return comp(key2(*first2), key1(a)); })};
+            RandomIt2 run_end2{std::find_if(first2 + 1, last2, [&](const auto &b)
+                                            { return comp(key1(*first1), key2(b)); })};
+            for (; first1 != run_end1; ++first1)
+            {
+                for (RandomIt2 itr = first2; itr != run_end2; ++itr)
+                {
+                    *d_first = Pair{*first1, *itr};
+                    ++d_first;
+                }
+            }
+            first2 = run_end2;
+        }
+    }
+    return d_first;
+}
+
+/*
+Merge path, see: https://arxiv.org/abs/1406.2628 (Green, Odeh and Birk). The first k
+elements of the merge of the two ranges are some i from range 1 and k - i from range 2,
+and i can be found with a binary search on the diagonal i + j = k: too small an i leaves
+an element of range 1 after one of range 2 that's bigger. Splitting at k = n / chunks,
+2n / chunks... gives every chunk the same number of elements to merge.
+
+For the set operations and joins an element has to meet its equivalents in the other
+range, so the split is then moved back to before the first element equivalent to the
+next one in the merge, in both ranges. Returns {i, j}.
+*/
+template <typename RandomIt1, typename RandomIt2, typename Key1, typename Key2, typename Compare>
+std::pair<size_t, size_t> MergePathCoRank(RandomIt1 first1, size_t n1, RandomIt2 first2, size_t n2, size_t k, Key1 key1, Key2 key2, Compare comp)
+{
+    size_t low{k > n2 ? k - n2 : 0};
+    size_t high{std::min(k, n1)};
+    while (low < high)
+    {
+        size_t i{low + (high - low) / 2};
+        // Ties go to range 1 first, so first1[i] belongs before the split unless first2[k - i - 1] is smaller
+        if (!comp(key2(first2[k - i - 1]), key1(first1[i])))
+        {
+            low = i + 1;
+        }
+        else
+        {
+            high = i;
+        }
+    }
+    size_t i{low};
+    size_t j{k - low};
+    if (i == n1 && j == n2)
+    {
+        return {i, j};
+    }
+    auto split_before{[&](const auto &key)
+                      {
+        i = std::partition_point(first1, first1 + i, [&](const auto &a)
+                                 { return comp(key1(a), key); }) -
+            first1;
+        j = std::partition_point(first2, first2 + j, [&](const auto &b)
+                                 { return comp(key2(b), key); }) -
+            first2; }};
+    if (j == n2 || (i < n1 && !comp(key2(first2[j]), key1(first1[i]))))
+    {
+        split_before(key1(first1[i]));
+    }
+    else
+    {
+        split_before(key2(first2[j]));
+    }
+    return {i, j};
+}
+
+/*
+Runs piece(first1, last1, first2, last2, out) on each merge path chunk of the two ranges,
+appending to a std::vector<T> per chunk, then copies the chunks to d_first (random access,
+each thread writes its own part) at offsets found by summing their sizes.
+*/
+template <typename T, typename RandomIt1, typename RandomIt2, typename OutputIt, typename Key1, typename Key2, typename Compare, typename Piece>
+OutputIt ParallelMergeChunks(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, unsigned num_chunks, Key1 key1, Key2 key2, Compare comp, Piece piece)
+{
+    size_t n1{static_cast<size_t>(last1 - first1)};
+    size_t n2{static_cast<size_t>(last2 - first2)};
+    size_t n{n1 + n2};
+    std::vector<std::vector<T>> outputs(num_chunks);
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t begin, size_t end)
+                   {
+        auto [begin1, begin2]{MergePathCoRank(first1, n1, first2, n2, begin, key1, key2, comp)};
+        auto [end1, end2]{MergePathCoRank(first1, n1, first2, n2, end, key1, key2, comp)};
+        piece(first1 + begin1, first1 + end1, first2 + begin2, first2 + end2, outputs[chunk]); });
+
+    std::vector<size_t> offsets(num_chunks, 0);
+    for (unsigned i = 1; i < num_chunks; i++)
+    {
+        offsets[i] = offsets[i - 1] + outputs[i - 1].size();
+    }
+    ParallelChunks(n, num_chunks, [&](unsigned chunk, size_t, size_t)
+                   { std::copy(outputs[chunk].cbegin(), outputs[chunk].cend(), d_first + offsets[chunk]); });
+    return d_first + (offsets.back() + outputs.back().size());
+}
+
+// SortedIntersection split across threads with merge path, d_first must be random access
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare = std::less<>>
+OutputIt ParallelSortedIntersection(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, unsigned num_threads = DefaultThreadCount(), Compare comp = Compare(), SimdLevel level = ActiveSimdLevel())
+{
+    unsigned num_chunks{ChunkCount(static_cast<size_t>((last1 - first1) + (last2 - first2)), num_threads)};
+    if (num_chunks == 1)
+    {
+        return SortedIntersection(first1, last1, first2, last2, d_first, comp, level);
+    }
+    using T = std::iter_value_t<RandomIt1>;
+    return ParallelMergeChunks<T>(first1, last1, first2, last2, d_first, num_chunks, std::identity(), std::identity(), comp, [&](auto f1, auto l1, auto f2, auto l2, std::vector<T> &out)
+                                  {
+        // Sized up front rather than appended to, so the int version can still use SIMD
+        out.resize(std::min(l1 - f1, l2 - f2));
+        out.erase(SortedIntersection(f1, l1, f2, l2, out.begin(), comp, level), out.end()); });
+}
+
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare = std::less<>>
+OutputIt ParallelSortedUnion(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, unsigned num_threads = DefaultThreadCount(), Compare comp = Compare())
+{
+    unsigned num_chunks{ChunkCount(static_cast<size_t>((last1 - first1) + (last2 - first2)), num_threads)};
+    if (num_chunks == 1)
+    {
+        return SortedUnion(first1, last1, first2, last2, d_first, comp);
+    }
+    using T = std::iter_value_t<RandomIt1>;
+    return ParallelMergeChunks<T>(first1, last1, first2, last2, d_first, num_chunks, std::identity(), std::identity(), comp, [&](auto f1, auto l1, auto f2, auto l2, std::vector<T> &out)
+                                  {
+        out.reserve((l1 - f1) + (l2 - f2));
+        SortedUnion(f1, l1, f2, l2, std::back_inserter(out), comp); });
+}
+
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare = std::less<>>
+OutputIt ParallelSortedDifference(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, unsigned num_threads = DefaultThreadCount(), Compare comp = Compare())
+{
+    unsigned num_chunks{ChunkCount(static_cast<size_t>((last1 - first1) + (last2 - first2)), num_threads)};
+    if (num_chunks == 1)
+    {
+        return SortedDifference(first1, last1, first2, last2, d_first, comp);
+    }
+    using T = std::iter_value_t<RandomIt1>;
+    return ParallelMergeChunks<T>(first1, last1, first2, last2, d_first, num_chunks, std::identity(), std::identity(), comp, [&](auto f1, auto l1, auto f2, auto l2, std::vector<T> &out)
+                                  {
+        out.reserve(l1 - f1);
+        SortedDifference(f1, l1, f2, l2, std::back_inserter(out), comp); });
+}
+
+/*
+MergeJoin split across threads with merge path. A key's run in each range always lands in
+one chunk, so a key repeated many times on both sides makes that chunk's thread do all of
+its pairs.
+*/
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Key1 = std::identity, typename Key2 = std::identity, typename Compare = std::less<>>
+OutputIt ParallelMergeJoin(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt d_first, unsigned num_threads = DefaultThreadCount(), Key1 key1 = Key1(), Key2 key2 = Key2(), Compare comp = Compare())
+{
+    unsigned num_chunks{ChunkCount(static_cast<size_t>((last1 - first1) + (last2 - first2)), num_threads)};
+    if (num_chunks == 1)
+    {
+        return MergeJoin(first1, last1, first2, last2, d_first, key1, key2, comp);
+    }
+    using Pair = std::pair<std::iter_value_t<RandomIt1>, std::iter_value_t<RandomIt2>>;
+    return ParallelMergeChunks<Pair>(first1, last1, first2, last2, d_first, num_chunks, key1, key2, comp, [&](auto f1, auto l1, auto f2, auto l2, std::vector<Pair> &out)
+                                     { MergeJoin(f1, l1, f2, l2, std::back_inserter(out), key1, key2, comp); });
+}
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+Vectorized count and find for int ranges (the std::count, std::count_if and std::find
+calls in main.cpp). SIMD (single instruction multiple data) instructions compare 4
+(SSE), 8 (AVX2) or 16 (AVX-512) ints at once, see:
+https://en.wikipedia.org/wiki/Single_instruction,_multiple_data
+
+Not every x86 CPU has AVX2 or AVX-512, so the instruction set can't be picked at
+compile time (with -mavx2) without the program crashing on older machines. Instead,
+each kernel is compiled for its instruction set with GCC/Clang's target attribute
+and the best one the CPU supports is picked at runtime from CPUID (which is what
+__builtin_cpu_supports reads), see:
+https://gcc.gnu.org/onlinedocs/gcc/x86-Function-Attributes.html
+https://gcc.gnu.org/onlinedocs/gcc/x86-Built-in-Functions.html
+
+SSE2 is used as the lowest vector level rather than SSE4.2 since 32 bit compares were
+already in SSE2 and every x86-64 CPU has it. Off x86 everything uses the scalar loops.
+
+Predicates are limited to ones that can be done with vector instructions: equality,
+and "masked" equality (e & mask) == value. The latter covers is_even from main.cpp
+((e & 1) == 0) and any modulus by a power of two for non-negative ints. For other
+predicates use std::count_if or ParallelCountIf (see parallel.h).
+*/
+
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+inline std::string SimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::SSE2:
+        return "SSE2";
+    case SimdLevel::AVX2:
+        return "AVX2";
+    case SimdLevel::AVX512:
+        return "AVX-512";
+    default:
+        return "scalar";
+    }
+}
+
+// Best level this CPU supports
+inline SimdLevel DetectSimdLevel()
+{
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return SimdLevel::SSE2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+// Detected once (static local variables are initialized on first call, thread safely)
+inline SimdLevel ActiveSimdLevel()
+{
+    static const SimdLevel level{DetectSimdLevel()};
+    return level;
+}
+
+inline size_t ScalarCountMasked(const int *data, size_t n, int mask, int value)
+{
+    size_t count{0};
+    for (size_t i = 0; i < n; i++)
+    {
+        count += (data[i] & mask) == value;
+    }
+    return count;
+}
+
+inline size_t ScalarFindMasked(const int *data, size_t n, int mask, int value)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if ((data[i] & mask) == value)
+        {
+            return i;
+        }
+    }
+    return n;
+}
+
+#ifdef SIMD_X86
+
+/*
+Counting works by keeping one counter per lane: a lane of a compare result is all 1
+bits (-1) when it matched, so subtracting the compare result adds 1 to each matching
+lane's counter. Lane counters are 32 bit, so they are added into the total every
+2^20 vectors, long before they could overflow.
+*/
+constexpr size_t SIMD_FLUSH_VECTORS{1 << 20};
+
+__attribute__((target("sse2"))) inline size_t SSE2CountMasked(const int *data, size_t n, int mask, int value)
+{
+    const __m128i masks{_mm_set1_epi32(mask)};
+    const __m128i values{_mm_set1_epi32(value)};
+    size_t count{0};
+    size_t i{0};
+    while (i + 4 <= n)
+    {
+        __m128i counts{_mm_setzero_si128()};
+        size_t block_end{std::min(n - n % 4, i + 4 * SIMD_FLUSH_VECTORS)};
+        for (; i < block_end; i += 4)
+        {
+            __m128i v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i))};
+            counts = _mm_sub_epi32(counts, _mm_cmpeq_epi32(_mm_and_si128(v, masks), values));
+        }
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(lanes), counts);
+        count += size_t{lanes[0]} + lanes[1] + lanes[2] + lanes[3];
+    }
+    return count + ScalarCountMasked(data + i, n - i, mask, value);
+}
+
+// movemask packs the top bit of each byte into an int, so the first match is its lowest set bit / 4
+__attribute__((target("sse2"))) inline size_t SSE2FindMasked(const int *data, size_t n, int mask, int value)
+{
+    const __m128i masks{_mm_set1_epi32(mask)};
+    const __m128i values{_mm_set1_epi32(value)};
+    size_t i{0};
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i v{_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i))};
+        int bits{_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(v, masks), values))};
+        if (bits != 0)
+        {
+            return i + __builtin_ctz(bits) / 4;
+        }
+    }
+    return i + ScalarFindMasked(data + i, n - i, mask, value);
+}
+
+__attribute__((target("avx2"))) inline size_t AVX2CountMasked(const int *data, size_t n, int mask, int value)
+{
+    const __m256i masks{_mm256_set1_epi32(mask)};
+    const __m256i values{_mm256_set1_epi32(value)};
+    size_t count{0};
+    size_t i{0};
+    while (i + 32 <= n)
+    {
+        // 4 independent counters so consecutive compares don't wait on each other
+        __m256i counts0{_mm256_setzero_si256()}, counts1{counts0}, counts2{counts0}, counts3{counts0};
+        size_t block_end{std::min(n - n % 32, i + 8 * SIMD_FLUSH_VECTORS)};
+        for (; i < block_end; i += 32)
+        {
+            const __m256i *p{reinterpret_cast<const __m256i *>(data + i)};
+            counts0 = _mm256_sub_epi32(counts0, _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(p), masks), values));
+            counts1 = _mm256_sub_epi32(counts1, _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(p + 1), masks), values));
+            counts2 = _mm256_sub_epi32(counts2, _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(p + 2), masks), values));
+            counts3 = _mm256_sub_epi32(counts3, _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(p + 3), masks), values));
+        }
+        alignas(32) uint32_t lanes[8];
+        for (__m256i counts : {counts0, counts1, counts2, counts3})
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), counts);
+            for (uint32_t lane : lanes)
+            {
+                count += lane;
+            }
+        }
+    }
+    return count + SSE2CountMasked(data + i, n - i, mask, value);
+}
+
+__attribute__((target("avx2"))) inline size_t AVX2FindMasked(const int *data, size_t n, int mask, int value)
+{
+    const __m256i masks{_mm256_set1_epi32(mask)};
+    const __m256i values{_mm256_set1_epi32(value)};
+    size_t i{0};
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i))};
+        unsigned bits{static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(v, masks), values)))};
+        if (bits != 0)
+        {
+            return i + __builtin_ctz(bits) / 4;
+        }
+    }
+    return i + SSE2FindMasked(data + i, n - i, mask, value);
+}
+
+// AVX-512 compares produce a 16 bit mask (one bit per lane) instead of a vector, so just popcount it
+__attribute__((target("avx512f,popcnt"))) inline size_t AVX512CountMasked(const int *data, size_t n, int mask, int value)
+{
+    const __m512i masks{_mm512_set1_epi32(mask)};
+    const __m512i values{_mm512_set1_epi32(value)};
+    size_t count0{0}, count1{0};
+    size_t i{0};
+    for (; i + 32 <= n; i += 32)
+    {
+        __m512i v0{_mm512_loadu_si512(data + i)};
+        __m512i v1{_mm512_loadu_si512(data + i + 16)};
+        count0 += __builtin_popcount(_mm512_cmpeq_epi32_mask(_mm512_and_si512(v0, masks), values));
+        count1 += __builtin_popcount(_mm512_cmpeq_epi32_mask(_mm512_and_si512(v1, masks), values));
+    }
+    // Remaining < 32 elements with a masked load, lanes past the end are excluded from the compare
+    for (; i < n; i += 16)
+    {
+        __mmask16 in_range{static_cast<__mmask16>(n - i >= 16 ? 0xFFFF : (1u << (n - i)) - 1)};
+        __m512i v{_mm512_maskz_loadu_epi32(in_range, data + i)};
+        count0 += __builtin_popcount(_mm512_mask_cmpeq_epi32_mask(in_range, _mm512_and_si512(v, masks), values));
+    }
+    return count0 + count1;
+}
+
+__attribute__((target("avx512f"))) inline size_t AVX512FindMasked(const int *data, size_t n, int mask, int value)
+{
+    const __m512i masks{_mm512_set1_epi32(mask)};
+    const __m512i values{_mm512_set1_epi32(value)};
+    for (size_t i = 0; i < n; i += 16)
+    {
+        __mmask16 in_range{static_cast<__mmask16>(n - i >= 16 ? 0xFFFF : (1u << (n - i)) - 1)};
+        __m512i v{_mm512_maskz_loadu_epi32(in_range, data + i)};
+        unsigned bits{_mm512_mask_cmpeq_epi32_mask(in_range, _mm512_and_si512(v, masks), values)};
+        if (bits != 0)
+        {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    return n;
+}
+
+#endif
+
+/*
+Number of elements e in data[0, n) with (e & mask) == value. level defaults to the best
+level the CPU supports, passing a lower one (e.g. for benchmarking) is fine but asking
+for one above what the CPU supports is lowered to ActiveSimdLevel().
+*/
+inline size_t SimdCountMasked(const int *data, size_t n, int mask, int value, SimdLevel level = ActiveSimdLevel())
+{
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512CountMasked(data, n, mask, value);
+    case SimdLevel::AVX2:
+        return AVX2CountMasked(data, n, mask, value);
+    case SimdLevel::SSE2:
+        return SSE2CountMasked(data, n, mask, value);
+    default:
+        break;
+    }
+#endif
+    return ScalarCountMasked(data, n, mask, value);
+}
+
+// Index of the first e in data[0, n) with (e & mask) == value, or n if there is none (like find returning end())
+inline size_t SimdFindMasked(const int *data, size_t n, int mask, int value, SimdLevel level = ActiveSimdLevel())
+{
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512FindMasked(data, n, mask, value);
+    case SimdLevel::AVX2:
+        return AVX2FindMasked(data, n, mask, value);
+    case SimdLevel::SSE2:
+        return SSE2FindMasked(data, n, mask, value);
+    default:
+        break;
+    }
+#endif
+    return ScalarFindMasked(data, n, mask, value);
+}
+
+// Equality is the mask with every bit set
+inline size_t SimdCount(const int *data, size_t n, int value, SimdLevel level = ActiveSimdLevel())
+{
+    return SimdCountMasked(data, n, ~0, value, level);
+}
+
+inline size_t SimdFind(const int *data, size_t n, int value, SimdLevel level = ActiveSimdLevel())
+{
+    return SimdFindMasked(data, n, ~0, value, level);
+}
+
+#endif
@@ -0,0 +1,422 @@
+#ifndef SORTING_NETWORK_H
+#define SORTING_NETWORK_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "simd.h"
+
+/*
+Sorting networks for tiny arrays of a size known at compile time, see:
+https://en.wikipedia.org/wiki/Sorting_network
+
+A network is a fixed list of compare-exchanges (put elements i and j in order), the same
+for every input, so there are no data dependent branches to mispredict and no loop or
+recursion overhead. std::sort on 8 ints spends most of its time deciding what to do
+next, a network for 8 is 19 min/max pairs.
+
+The networks are Batcher's merge exchange (Knuth, TAOCP vol. 3, 5.2.2 algorithm M),
+generated at compile time for any N. Up to N = 8 they have the fewest possible
+comparators, above that a few more than the best known networks (63 vs 60 for 16, 191
+vs 185 for 32), in exchange for not carrying a table of hand found networks.
+
+- SortN<N>(first, comp) sorts one array. Compare-exchanges are written as selects
+  (compiled to conditional moves or min/max instructions) for trivially copyable types.
+- SimdSortNBatch<N>(data, count) sorts count int or float arrays of N stored one after
+  another, a vector's worth at a time: the arrays are transposed so that vector j holds
+  element j of 4 (SSE2), 8 (AVX2) or 16 (AVX-512) arrays, and each compare-exchange is
+  one vector min and one vector max. NaNs aren't supported (neither are they by std::sort).
+*/
+
+// Largest N a network can be generated for, comparator indices are stored as bytes
+constexpr size_t MAX_SORTING_NETWORK_SIZE{256};
+
+/*
+Calls f(i, j) for each comparator of Batcher's merge exchange network for n elements, in
+order. Each pass compares elements d apart whose indices have a given bit pattern, the
+same passes as a bitonic/odd-even merge sort but working for any n, not just powers of 2.
+*/
+template <typename Function>
+constexpr void ForEachMergeExchange(size_t n, Function f)
+{
+    if (n < 2)
+    {
+        return;
+    }
+    size_t t{0};
+    while ((size_t{1} << t) < n)
+    {
+        t++;
+    }
+    for (size_t p = size_t{1} << (t - 1); p > 0; p /= 2)
+    {
+        size_t q{size_t{1} << (t - 1)};
+        size_t r{0};
+        size_t d{p};
+        while (true)
+        {
+            for (size_t i = 0; i + d < n; i++)
+            {
+                if ((i & p) == r)
+                {
+                    f(i, i + d);
+                }
+            }
+            if (q == p)
+            {
+                break;
+            }
+            d = q - p;
+            q /= 2;
+            r = p;
+        }
+    }
+}
+
+constexpr size_t SortingNetworkSize(size_t n)
+{
+    size_t size{0};
+    ForEachMergeExchange(n, [&](size_t, size_t)
+                         { size++; });
+    return size;
+}
+
+struct Comparator
+{
+    uint8_t i;
+    uint8_t j;
+};
+
+// The comparators of the network for N elements, i < j in each
+template <size_t N>
+constexpr std::array<Comparator, SortingNetworkSize(N)> SortingNetwork()
+{
+    static_assert(N <= MAX_SORTING_NETWORK_SIZE, "Sorting network indices are stored as bytes");
+    std::array<Comparator, SortingNetworkSize(N)> network{};
+    size_t count{0};
+    ForEachMergeExchange(N, [&](size_t i, size_t j)
+                         { network[count++] = Comparator{static_cast<uint8_t>(i), static_cast<uint8_t>(j)}; });
+    return network;
+}
+
+/*
+Puts a and b in order (a first), without a branch for trivially copyable types. Floats
+compared with std::less or std::greater use std::min and std::max, which compile to
+min/max instructions where the select below gets a branch. Both return their first
+argument when the two are equal (as -0.0 and 0.0 are), so the operands are swapped for
+the second call: a tie keeps a in one and b in the other, and nothing gets duplicated.
+*/
+template <typename T, typename Compare>
+inline void CompareExchange(T &a, T &b, Compare comp)
+{
+    constexpr bool ascending{std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>};
+    constexpr bool descending{std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<T>>};
+    if constexpr (std::is_floating_point_v<T> && (ascending || descending))
+    {
+        T low{ascending ? std::min(a, b) : std::max(a, b)};
+        T high{ascending ? std::max(b, a) : std::min(b, a)};
+        a = low;
+        b = high;
+    }
+    else if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        bool swap{comp(b, a)};
+        T low{swap ? b : a};
+        T high{swap ? a : b};
+        a = low;
+        b = high;
+    }
+    else if (comp(b, a))
+    {
+        std::swap(a, b);
+    }
+}
+
+/*
+Sorts [first, first + N) with comp (a strict weak ordering as for std::sort). Not
+stable. Trivially copyable elements are copied to a local array first so the compiler
+can keep them all in registers while the network runs.
+*/
+template <size_t N, typename RandomIt, typename Compare = std::less<>>
+void SortN(RandomIt first, Compare comp = Compare())
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    constexpr auto network{SortingNetwork<N>()};
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        std::array<T, N> v;
+        std::copy(first, first + N, v.begin());
+#pragma GCC unroll 1024
+        for (const auto &c : network)
+        {
+            CompareExchange(v[c.i], v[c.j], comp);
+        }
+        std::copy(v.cbegin(), v.cend(), first);
+    }
+    else
+    {
+        for (const auto &c : network)
+        {
+            CompareExchange(first[c.i], first[c.j], comp);
+        }
+    }
+}
+
+template <size_t N, typename T>
+void ScalarSortNBatch(T *data, size_t count)
+{
+    for (size_t a = 0; a < count; a++)
+    {
+        SortN<N>(data + a * N);
+    }
+}
+
+#ifdef SIMD_X86
+
+/*
+Overloads for each level so that one kernel template covers ints and floats. SSE2 has no
+32 bit int min/max (those came in SSE4.1), so they're a compare and a select by mask.
+*/
+__attribute__((target("sse2"))) inline __m128i SSE2Load(const int *p)
+{
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+}
+__attribute__((target("sse2"))) inline __m128 SSE2Load(const float *p)
+{
+    return _mm_load_ps(p);
+}
+__attribute__((target("sse2"))) inline void SSE2Store(int *p, __m128i v)
+{
+    _mm_store_si128(reinterpret_cast<__m128i *>(p), v);
+}
+__attribute__((target("sse2"))) inline void SSE2Store(float *p, __m128 v)
+{
+    _mm_store_ps(p, v);
+}
+__attribute__((target("sse2"))) inline void SSE2MinMax(__m128i &a, __m128i &b)
+{
+    __m128i greater{_mm_cmpgt_epi32(a, b)};
+    __m128i low{_mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a))};
+    b = _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+    a = low;
+}
+__attribute__((target("sse2"))) inline void SSE2MinMax(__m128 &a, __m128 &b)
+{
+    // min_ps and max_ps return their second operand when equal (-0.0 and 0.0), so each gets a different one
+    __m128 low{_mm_min_ps(b, a)};
+    b = _mm_max_ps(a, b);
+    a = low;
+}
+
+__attribute__((target("avx2"))) inline __m256i AVX2Load(const int *p)
+{
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+}
+__attribute__((target("avx2"))) inline __m256 AVX2Load(const float *p)
+{
+    return _mm256_load_ps(p);
+}
+__attribute__((target("avx2"))) inline void AVX2Store(int *p, __m256i v)
+{
+    _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+}
+__attribute__((target("avx2"))) inline void AVX2Store(float *p, __m256 v)
+{
+    _mm256_store_ps(p, v);
+}
+__attribute__((target("avx2"))) inline void AVX2MinMax(__m256i &a, __m256i &b)
+{
+    __m256i low{_mm256_min_epi32(a, b)};
+    b = _mm256_max_epi32(a, b);
+    a = low;
+}
+__attribute__((target("avx2"))) inline void AVX2MinMax(__m256 &a, __m256 &b)
+{
+    __m256 low{_mm256_min_ps(b, a)};
+    b = _mm256_max_ps(a, b);
+    a = low;
+}
+
+// Elements p[index[lane]], masked forms for the same reason as below
+__attribute__((target("avx512f"))) inline __m512i AVX512Gather(const int *p, __m512i index)
+{
+    return _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, index, p, 4);
+}
+__attribute__((target("avx512f"))) inline __m512 AVX512Gather(const float *p, __m512i index)
+{
+    return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, index, p, 4);
+}
+__attribute__((target("avx512f"))) inline void AVX512Scatter(int *p, __m512i index, __m512i v)
+{
+    _mm512_i32scatter_epi32(p, index, v, 4);
+}
+__attribute__((target("avx512f"))) inline void AVX512Scatter(float *p, __m512i index, __m512 v)
+{
+    _mm512_i32scatter_ps(p, index, v, 4);
+}
+// maskz_ forms with every lane selected, the plain ones make GCC warn about an uninitialized temporary in its headers (see scan.h)
+__attribute__((target("avx512f"))) inline void AVX512MinMax(__m512i &a, __m512i &b)
+{
+    __m512i low{_mm512_maskz_min_epi32(0xFFFF, a, b)};
+    b = _mm512_maskz_max_epi32(0xFFFF, a, b);
+    a = low;
+}
+__attribute__((target("avx512f"))) inline void AVX512MinMax(__m512 &a, __m512 &b)
+{
+    __m512 low{_mm512_maskz_min_ps(0xFFFF, b, a)};
+    b = _mm512_maskz_max_ps(0xFFFF, a, b);
+    a = low;
+}
+
+/*
+The kernels move Lanes arrays at a time into columns (columns[j] holding element j of
+each), load each column as a vector, run the network on the vectors and write back the
+same way. The transposes are plain loops over a small buffer that stays in L1, they cost
+about as much as the network itself for small N but far less than the branches of
+std::sort. AVX-512 can gather each column straight from the arrays with one instruction
+(and scatter it back), which is faster than the buffer for all but N = 2. Arrays left
+over at the end (fewer than Lanes) get SortN.
+*/
+template <size_t N, typename T>
+__attribute__((target("sse2"))) void SSE2SortNBatch(T *data, size_t count)
+{
+    constexpr size_t LANES{4};
+    constexpr auto network{SortingNetwork<N>()};
+    alignas(16) T columns[N][LANES];
+    size_t a{0};
+    for (; a + LANES <= count; a += LANES)
+    {
+        for (size_t lane = 0; lane < LANES; lane++)
+        {
+            for (size_t j = 0; j < N; j++)
+            {
+                columns[j][lane] = data[(a + lane) * N + j];
+            }
+        }
+        decltype(SSE2Load(data)) v[N];
+        for (size_t j = 0; j < N; j++)
+        {
+            v[j] = SSE2Load(columns[j]);
+        }
+#pragma GCC unroll 1024
+        for (const auto &c : network)
+        {
+            SSE2MinMax(v[c.i], v[c.j]);
+        }
+        for (size_t j = 0; j < N; j++)
+        {
+            SSE2Store(columns[j], v[j]);
+        }
+        for (size_t lane = 0; lane < LANES; lane++)
+        {
+            for (size_t j = 0; j < N; j++)
+            {
+                data[(a + lane) * N + j] = columns[j][lane];
+            }
+        }
+    }
+    ScalarSortNBatch<N>(data + a * N, count - a);
+}
+
+template <size_t N, typename T>
+__attribute__((target("avx2"))) void AVX2SortNBatch(T *data, size_t count)
+{
+    constexpr size_t LANES{8};
+    constexpr auto network{SortingNetwork<N>()};
+    alignas(32) T columns[N][LANES];
+    size_t a{0};
+    for (; a + LANES <= count; a += LANES)
+    {
+        for (size_t lane = 0; lane < LANES; lane++)
+        {
+            for (size_t j = 0; j < N; j++)
+            {
+                columns[j][lane] = data[(a + lane) * N + j];
+            }
+        }
+        decltype(AVX2Load(data)) v[N];
+        for (size_t j = 0; j < N; j++)
+        {
+            v[j] = AVX2Load(columns[j]);
+        }
+#pragma GCC unroll 1024
+        for (const auto &c : network)
+        {
+            AVX2MinMax(v[c.i], v[c.j]);
+        }
+        for (size_t j = 0; j < N; j++)
+        {
+            AVX2Store(columns[j], v[j]);
+        }
+        for (size_t lane = 0; lane < LANES; lane++)
+        {
+            for (size_t j = 0; j < N; j++)
+            {
+                data[(a + lane) * N + j] = columns[j][lane];
+            }
+        }
+    }
+    ScalarSortNBatch<N>(data + a * N, count - a);
+}
+
+template <size_t N, typename T>
+__attribute__((target("avx512f"))) void AVX512SortNBatch(T *data, size_t count)
+{
+    constexpr size_t LANES{16};
+    constexpr auto network{SortingNetwork<N>()};
+    __m512i index{_mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(N))};
+    size_t a{0};
+    for (; a + LANES <= count; a += LANES)
+    {
+        T *block{data + a * N};
+        decltype(AVX512Gather(data, index)) v[N];
+        for (size_t j = 0; j < N; j++)
+        {
+            v[j] = AVX512Gather(block + j, index);
+        }
+#pragma GCC unroll 1024
+        for (const auto &c : network)
+        {
+            AVX512MinMax(v[c.i], v[c.j]);
+        }
+        for (size_t j = 0; j < N; j++)
+        {
+            AVX512Scatter(block + j, index, v[j]);
+        }
+    }
+    ScalarSortNBatch<N>(data + a * N, count - a);
+}
+
+#endif
+
+/*
+Sorts each of the count arrays data[a * N, (a + 1) * N), T is int or float. level works
+as in simd.h.
+*/
+template <size_t N, typename T>
+void SimdSortNBatch(T *data, size_t count, SimdLevel level = ActiveSimdLevel())
+{
+    static_assert(std::is_same_v<T, int> || std::is_same_v<T, float>, "SimdSortNBatch sorts ints or floats");
+#ifdef SIMD_X86
+    switch (std::min(level, ActiveSimdLevel()))
+    {
+    case SimdLevel::AVX512:
+        return AVX512SortNBatch<N>(data, count);
+    case SimdLevel::AVX2:
+        return AVX2SortNBatch<N>(data, count);
+    case SimdLevel::SSE2:
+        return SSE2SortNBatch<N>(data, count);
+    default:
+        break;
+    }
+#endif
+    ScalarSortNBatch<N>(data, count);
+}
+
+#endif
@@ -0,0 +1,218 @@
+#ifndef STATIC_INDEX_H
+#define STATIC_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/*
+Read only search index over a sorted vector, answering lower_bound, upper_bound and
+binary_search (contains) with the same results as the std:: versions, but faster on
+big arrays.
+
+std::lower_bound halves the range each step, so on an array much bigger than the CPU
+cache nearly every step is a cache miss, and the next address isn't known until the
+previous load finishes. This stores the keys as a static B+ tree instead (the "S+
+tree" from https://en.algorithmica.org/hpc/data-structures/s-tree/): each node is
+one 64 byte cache line holding 16 ints, and a search reads one node per level, so it
+does log_17(n) cache misses instead of log_2(n) (7 instead of 27 for 10^8 keys).
+
+The bottom level of the tree is just the sorted keys (padded to a multiple of 16),
+so the position of a leaf key is its index in the original vector and lower_bound can
+return an index like std::distance(vec.cbegin(), std::lower_bound(...)) does. The
+levels above hold, for each child but the first, the smallest key under that child.
+
+Inside a node there is no early exit: the number of keys less than the query is
+counted over all 16 keys, which the compiler turns into a couple of vector
+instructions with no branches to mispredict.
+*/
+template <typename T>
+class StaticSortedIndex
+{
+    static_assert(std::is_arithmetic_v<T>, "StaticSortedIndex needs integer or floating point keys");
+
+private:
+    // Keys per node, one cache line's worth
+    static constexpr size_t B{64 / sizeof(T)};
+
+    /*
+    Unused slots are filled with the largest possible value, so they are never counted
+    as < x. They are counted as <= x when x is that largest value, which would walk off
+    the end of the tree, so upper_bound of PAD is answered without searching.
+    */
+    static constexpr T PAD{std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max()};
+
+    // Nodes need to start on cache line boundaries, which new T[] doesn't promise
+    struct AlignedDelete
+    {
+        void operator()(T *p) const
+        {
+            ::operator delete[](p, std::align_val_t{64});
+        }
+    };
+
+    std::unique_ptr<T[], AlignedDelete> keys;
+    size_t n;
+    // Where each level starts in keys, from the root (one node) down to the leaves
+    std::vector<size_t> offsets;
+
+    // Number of keys in node that are < x (or <= x when Upper, for upper_bound)
+    template <bool Upper>
+    static size_t CountBefore(const T *node, T x)
+    {
+        size_t count{0};
+        for (size_t i = 0; i < B; i++)
+        {
+            count += Upper ? node[i] <= x : node[i] < x;
+        }
+        return count;
+    }
+
+    template <bool Upper>
+    size_t Search(T x) const
+    {
+        if (Upper && x == PAD)
+        {
+            return n;
+        }
+        size_t node{0};
+        for (size_t level = 0; level + 1 < offsets.size(); level++)
+        {
+            node = node * (B + 1) + CountBefore<Upper>(keys.get() + offsets[level] + node * B, x);
+        }
+        return std::min(n, node * B + CountBefore<Upper>(keys.get() + offsets.back() + node * B, x));
+    }
+
+    /*
+    Runs a group of searches together one level at a time. While one search waits for its
+    node to arrive from memory the others keep going, and each search asks for its next
+    node to be prefetched as soon as it knows which one it is.
+    */
+    template <bool Upper>
+    void SearchBatch(const T *queries, size_t count, size_t *results) const
+    {
+        constexpr size_t GROUP{16};
+        for (size_t start = 0; start < count; start += GROUP)
+        {
+            size_t group_size{std::min(GROUP, count - start)};
+            size_t nodes[GROUP]{};
+            for (size_t level = 0; level + 1 < offsets.size(); level++)
+            {
+                for (size_t q = 0; q < group_size; q++)
+                {
+                    // PAD queries for upper_bound stay on the first path and are answered below
+                    if (Upper && queries[start + q] == PAD)
+                    {
+                        continue;
+                    }
+                    nodes[q] = nodes[q] * (B + 1) + CountBefore<Upper>(keys.get() + offsets[level] + nodes[q] * B, queries[start + q]);
+                    __builtin_prefetch(keys.get() + offsets[level + 1] + nodes[q] * B);
+                }
+            }
+            for (size_t q = 0; q < group_size; q++)
+            {
+                if (Upper && queries[start + q] == PAD)
+                {
+                    results[start + q] = n;
+                    continue;
+                }
+                results[start + q] = std::min(n, nodes[q] * B + CountBefore<Upper>(keys.get() + offsets.back() + nodes[q] * B, queries[start + q]));
+            }
+        }
+    }
+
+public:
+    // sorted must be sorted ascending (as std::lower_bound requires) and have no NaNs, the keys are copied
+    explicit StaticSortedIndex(const std::vector<T> &sorted) : n(sorted.size())
+    {
+        // Build levels bottom up, along with the smallest key under each node of the level below
+        std::vector<std::vector<T>> levels;
+        size_t num_nodes{std::max<size_t>(1, (n + B - 1) / B)};
+        levels.emplace_back(num_nodes * B, PAD);
+        std::copy(sorted.cbegin(), sorted.cend(), levels.back().begin());
+        std::vector<T> smallest(num_nodes);
+        for (size_t i = 0; i < num_nodes; i++)
+        {
+            smallest[i] = levels.back()[i * B];
+        }
+
+        while (num_nodes > 1)
+        {
+            size_t num_parents{(num_nodes + B) / (B + 1)};
+            std::vector<T> level(num_parents * B, PAD);
+            std::vector<T> parent_smallest(num_parents);
+            for (size_t parent = 0; parent < num_parents; parent++)
+            {
+                size_t first_child{parent * (B + 1)};
+                parent_smallest[parent] = smallest[first_child];
+                for (size_t j = 0; j < B && first_child + j + 1 < num_nodes; j++)
+                {
+                    level[parent * B + j] = smallest[first_child + j + 1];
+                }
+            }
+            levels.push_back(std::move(level));
+            smallest = std::move(parent_smallest);
+            num_nodes = num_parents;
+        }
+
+        // Lay the levels out root first in one cache line aligned array
+        size_t total{0};
+        for (auto itr = levels.crbegin(); itr != levels.crend(); itr++)
+        {
+            offsets.push_back(total);
+            total += itr->size();
+        }
+        keys.reset(static_cast<T *>(::operator new[](total * sizeof(T), std::align_val_t{64})));
+        for (size_t level = 0; level < offsets.size(); level++)
+        {
+            const auto &keys_at_level{levels[levels.size() - 1 - level]};
+            std::copy(keys_at_level.cbegin(), keys_at_level.cend(), keys.get() + offsets[level]);
+        }
+    }
+
+    // Index of the first key >= x, or size() if there is none
+    size_t LowerBound(T x) const
+    {
+        return Search<false>(x);
+    }
+
+    // Index of the first key > x, or size() if there is none
+    size_t UpperBound(T x) const
+    {
+        return Search<true>(x);
+    }
+
+    bool Contains(T x) const
+    {
+        size_t i{LowerBound(x)};
+        return i < n && keys[offsets.back() + i] == x;
+    }
+
+    // Key at index i of the original sorted vector
+    T operator[](size_t i) const
+    {
+        return keys[offsets.back() + i];
+    }
+
+    size_t size() const
+    {
+        return n;
+    }
+
+    // results[i] = LowerBound(queries[i]) for i in [0, count), faster than calling LowerBound in a loop
+    void LowerBoundBatch(const T *queries, size_t count, size_t *results) const
+    {
+        SearchBatch<false>(queries, count, results);
+    }
+
+    void UpperBoundBatch(const T *queries, size_t count, size_t *results) const
+    {
+        SearchBatch<true>(queries, count, results);
+    }
+};
+
+#endif
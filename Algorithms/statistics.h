@@ -0,0 +1,154 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "parallel.h"
+
+/*
+RangeCounter in main.cpp is passed to for_each by value, so for_each counts with its
+own copy and the counter in main stays at 0. for_each does return its copy though, so
+the fix is to use the return value:
+    counter = std::for_each(vec.cbegin(), vec.cend(), counter);
+StatisticsAccumulator is meant to be used that way, and also collects count, sum, min,
+max, mean, variance and a histogram. It has a Merge so that ParallelForEach (see
+parallel.h) can run one accumulator per thread and combine them at the end.
+*/
+
+// What StatisticsAccumulator::Result() returns
+template <typename T>
+struct Statistics
+{
+    size_t count;
+    double sum;
+    T min;
+    T max;
+    double mean;
+    // Population variance (divides by count), see SampleVariance for count - 1
+    double variance;
+
+    // Histogram of num_buckets equal width buckets over [low, high)
+    double low;
+    double high;
+    std::vector<size_t> buckets;
+    // Elements < low and >= high
+    size_t underflow;
+    size_t overflow;
+
+    double SampleVariance() const
+    {
+        return count > 1 ? variance * count / (count - 1) : 0.0;
+    }
+
+    double StandardDeviation() const
+    {
+        return std::sqrt(variance);
+    }
+};
+
+/*
+Mean and variance are updated with Welford's method rather than from a sum of squares,
+which loses most of its precision when the values are large compared to their spread.
+Two accumulators are merged with Chan et al.'s formula, see:
+https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+*/
+template <typename T>
+class StatisticsAccumulator
+{
+private:
+    size_t count;
+    double sum;
+    T min;
+    T max;
+    double mean;
+    // Sum of squared differences from the mean
+    double m2;
+    double low;
+    double high;
+    double buckets_per_unit;
+    std::vector<size_t> buckets;
+    size_t underflow;
+    size_t overflow;
+
+public:
+    // No histogram
+    StatisticsAccumulator() : StatisticsAccumulator(0.0, 0.0, 0) {}
+
+    // Histogram of num_buckets equal width buckets over [l, h)
+    StatisticsAccumulator(double l, double h, size_t num_buckets)
+        : count(0), sum(0.0), min(std::numeric_limits<T>::max()), max(std::numeric_limits<T>::lowest()), mean(0.0), m2(0.0),
+          low(l), high(h), buckets_per_unit(h > l ? num_buckets / (h - l) : 0.0), buckets(num_buckets), underflow(0), overflow(0) {}
+
+    // Same shape as RangeCounter's operator(), so it can be passed to for_each
+    void operator()(const T &e)
+    {
+        count++;
+        sum += e;
+        min = std::min(min, e);
+        max = std::max(max, e);
+        double delta{e - mean};
+        mean += delta / count;
+        m2 += delta * (e - mean);
+
+        if (!buckets.empty())
+        {
+            double x{static_cast<double>(e)};
+            if (x < low)
+            {
+                underflow++;
+            }
+            else if (x >= high)
+            {
+                overflow++;
+            }
+            else
+            {
+                // min guards against rounding putting something just below high into bucket num_buckets
+                buckets[std::min(buckets.size() - 1, static_cast<size_t>((x - low) * buckets_per_unit))]++;
+            }
+        }
+    }
+
+    // Combine with an accumulator that saw other elements (must have the same histogram settings)
+    void Merge(const StatisticsAccumulator &other)
+    {
+        if (other.count == 0)
+        {
+            return;
+        }
+        size_t total{count + other.count};
+        double delta{other.mean - mean};
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / total);
+        count = total;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        for (size_t i = 0; i < buckets.size(); i++)
+        {
+            buckets[i] += other.buckets[i];
+        }
+        underflow += other.underflow;
+        overflow += other.overflow;
+    }
+
+    // For an empty range min and max are left at the largest and smallest values of T
+    Statistics<T> Result() const
+    {
+        return Statistics<T>{count, sum, min, max, mean, count > 0 ? m2 / count : 0.0, low, high, buckets, underflow, overflow};
+    }
+};
+
+// Statistics of [first, last) computed with one accumulator (shard) per thread
+template <typename RandomIt, typename T = typename std::iterator_traits<RandomIt>::value_type>
+Statistics<T> ParallelStatistics(RandomIt first, RandomIt last, StatisticsAccumulator<T> accumulator = {}, unsigned num_threads = DefaultThreadCount())
+{
+    return ParallelForEach(first, last, std::move(accumulator), num_threads).Result();
+}
+
+#endif
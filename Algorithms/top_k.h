@@ -0,0 +1,138 @@
+#ifndef TOP_K_H
+#define TOP_K_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "parallel.h"
+
+/*
+Top k selection: the k elements that would come first if the range were sorted with comp,
+in that order (so std::greater<int>() gives the k largest, biggest first, and the default
+std::less gives the k smallest). Sorting all n elements to keep k of them does
+O(n log n) work, these do O(n) or O(n log k).
+
+- SelectTopK rearranges a random access range in place, like std::partial_sort.
+- TopK leaves the range alone and works on any input iterator (e.g. reading from a
+  stream), keeping only k elements at a time in a StreamingTopK.
+- ParallelTopK gives each thread its own StreamingTopK and merges them.
+*/
+
+// Below n / this many, SelectTopK keeps a heap of k elements instead of using nth_element
+constexpr size_t TOP_K_HEAP_DIVISOR{128};
+
+/*
+Moves the top k elements to [first, first + k) in sorted order and returns first + k
+(or last when k >= n). For large k, std::nth_element (introselect in GCC: quickselect
+that falls back to median of medians when it's unlucky) puts the k-th element in place
+with everything before it in O(n), then only those k get sorted. For small k (the
+usual case, e.g. top 100 of millions) std::partial_sort's heap of k elements is faster:
+once the heap has filled, almost every element is rejected with a single comparison
+against the heap's front, while nth_element keeps moving elements around.
+*/
+template <typename RandomIt, typename Compare = std::less<>>
+RandomIt SelectTopK(RandomIt first, RandomIt last, size_t k, Compare comp = Compare())
+{
+    size_t n{static_cast<size_t>(last - first)};
+    if (k >= n)
+    {
+        std::sort(first, last, comp);
+        return last;
+    }
+    if (k < n / TOP_K_HEAP_DIVISOR)
+    {
+        std::partial_sort(first, first + k, last, comp);
+        return first + k;
+    }
+    std::nth_element(first, first + k, last, comp);
+    std::sort(first, first + k, comp);
+    return first + k;
+}
+
+/*
+Keeps the top k of every element pushed into it, never storing more than k. They are
+kept as a heap whose front is the worst of them, so a new element that doesn't beat the
+front (most of them once the heap has filled) costs one comparison, and one that does
+replaces the front in O(log k).
+
+It has the same shape as StatisticsAccumulator (see statistics.h): operator() to pass it to
+for_each, and Merge so ParallelForEach can combine per thread copies.
+*/
+template <typename T, typename Compare = std::less<>>
+class StreamingTopK
+{
+private:
+    size_t k;
+    Compare comp;
+    std::vector<T> heap;
+
+public:
+    explicit StreamingTopK(size_t max_size, Compare c = Compare()) : k(max_size), comp(c)
+    {
+        heap.reserve(k);
+    }
+
+    void Push(const T &e)
+    {
+        if (heap.size() < k)
+        {
+            heap.push_back(e);
+            std::push_heap(heap.begin(), heap.end(), comp);
+            return;
+        }
+        // Once the heap is full, most elements are rejected here
+        if (k == 0 || !comp(e, heap.front()))
+        {
+            return;
+        }
+        std::pop_heap(heap.begin(), heap.end(), comp);
+        heap.back() = e;
+        std::push_heap(heap.begin(), heap.end(), comp);
+    }
+
+    void operator()(const T &e)
+    {
+        Push(e);
+    }
+
+    void Merge(const StreamingTopK &other)
+    {
+        for (const auto &e : other.heap)
+        {
+            Push(e);
+        }
+    }
+
+    // Number of elements kept so far, at most k
+    size_t size() const
+    {
+        return heap.size();
+    }
+
+    // The kept elements sorted with comp, best first
+    std::vector<T> Result() const
+    {
+        std::vector<T> sorted(heap);
+        std::sort_heap(sorted.begin(), sorted.end(), comp);
+        return sorted;
+    }
+};
+
+// Top k of [first, last) sorted with comp, the range is only read once and not modified
+template <typename InputIt, typename Compare = std::less<>, typename T = typename std::iterator_traits<InputIt>::value_type>
+std::vector<T> TopK(InputIt first, InputIt last, size_t k, Compare comp = Compare())
+{
+    return std::for_each(first, last, StreamingTopK<T, Compare>(k, comp)).Result();
+}
+
+// TopK with the range split across threads, each thread keeps its own k before they're merged
+template <typename RandomIt, typename Compare = std::less<>, typename T = typename std::iterator_traits<RandomIt>::value_type>
+std::vector<T> ParallelTopK(RandomIt first, RandomIt last, size_t k, Compare comp = Compare(), unsigned num_threads = DefaultThreadCount())
+{
+    return ParallelForEach(first, last, StreamingTopK<T, Compare>(k, comp), num_threads).Result();
+}
+
+#endif
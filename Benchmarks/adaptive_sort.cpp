@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Algorithms/adaptive_sort.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+std::sort, std::stable_sort, PdqSort and PowerSort over a matrix of input shapes: random,
+already sorted, reversed, sorted with the last 1% random (like appending to a sorted
+log), 16 distinct values, organ pipe (up then down) and sawtooth (sorted runs of 1000).
+The adaptive sorts should be close to the std ones on random input and much faster on
+the shapes whose order they can use.
+*/
+void BenchAdaptiveSort(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> random{RandomInts(n)};
+        std::vector<int> sorted{random};
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<int> reversed(sorted.crbegin(), sorted.crend());
+        std::vector<int> sorted_tail{sorted};
+        std::copy(random.cend() - n / 100, random.cend(), sorted_tail.end() - n / 100);
+        std::vector<int> few_unique{RandomInts(n, 0, 15)};
+        std::vector<int> organ_pipe(n);
+        std::vector<int> sawtooth(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            organ_pipe[i] = static_cast<int>(i < n / 2 ? i : n - i);
+            sawtooth[i] = static_cast<int>(i % 1000);
+        }
+        std::vector<std::pair<std::string, const std::vector<int> *>> inputs{
+            {"random", &random}, {"sorted", &sorted}, {"reversed", &reversed}, {"sorted + 1% random", &sorted_tail}, {"16 values", &few_unique}, {"organ pipe", &organ_pipe}, {"sawtooth", &sawtooth}};
+
+        std::vector<int> vec(n);
+        double seconds;
+        for (const auto &[shape, input] : inputs)
+        {
+            std::string suffix{" (" + shape + ")"};
+
+            vec = *input;
+            seconds = SecondsToRun([&]
+                                   { std::sort(vec.begin(), vec.end()); });
+            PrintResult("std::sort" + suffix, n, seconds);
+            vec = *input;
+            seconds = SecondsToRun([&]
+                                   { PdqSort(vec.begin(), vec.end()); });
+            PrintResult("PdqSort" + suffix, n, seconds);
+            vec = *input;
+            seconds = SecondsToRun([&]
+                                   { std::stable_sort(vec.begin(), vec.end()); });
+            PrintResult("std::stable_sort" + suffix, n, seconds);
+            vec = *input;
+            seconds = SecondsToRun([&]
+                                   { PowerSort(vec.begin(), vec.end()); });
+            PrintResult("PowerSort" + suffix, n, seconds);
+            bench_sink = vec[n / 2];
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Results of benchmarked calls are stored here so the optimizer can't decide a call's
+result is unused and delete the call (volatile writes can't be optimized away).
+*/
+inline volatile size_t bench_sink{0};
+
+// Wall clock seconds taken by f(), steady_clock is used since it never jumps backwards
+template <typename Function>
+double SecondsToRun(Function f)
+{
+    auto start{std::chrono::steady_clock::now()};
+    f();
+    std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+    return elapsed.count();
+}
+
+// Fixed seed so every run (and every benchmark) sees the same input
+inline std::vector<int> RandomInts(size_t n, int min = 0, int max = 1'000'000'000, unsigned seed = 42)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(min, max);
+    std::vector<int> vec(n);
+    for (auto &e : vec)
+    {
+        e = dist(gen);
+    }
+    return vec;
+}
+
+// Random lowercase strings with lengths in [min_length, max_length], e.g. names for Records
+inline std::vector<std::string> RandomStrings(size_t n, size_t min_length, size_t max_length, unsigned seed = 42)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> length(min_length, max_length);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::vector<std::string> strings(n);
+    for (auto &s : strings)
+    {
+        s.resize(length(gen));
+        for (auto &c : s)
+        {
+            c = static_cast<char>(letter(gen));
+        }
+    }
+    return strings;
+}
+
+// 1, 2, 4, ... up to (and including) the number of hardware threads
+inline std::vector<unsigned> ThreadCounts()
+{
+    unsigned max_threads{std::max(1u, std::thread::hardware_concurrency())};
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2)
+    {
+        counts.push_back(t);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+// Input sizes from 1K growing by 16x up to max_size
+inline std::vector<size_t> InputSizes(size_t max_size, size_t min_size = 1 << 10, size_t factor = 16)
+{
+    std::vector<size_t> sizes;
+    for (size_t n = min_size; n < max_size; n *= factor)
+    {
+        sizes.push_back(n);
+    }
+    sizes.push_back(max_size);
+    return sizes;
+}
+
+// Prints one row of results: what ran, on how many elements, and millions of elements per second
+inline void PrintResult(const std::string &name, size_t n, double seconds)
+{
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << n
+              << std::setw(12) << std::fixed << std::setprecision(1) << n / seconds / 1e6 << " M/s" << std::endl;
+}
+
+#endif
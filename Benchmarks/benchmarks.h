@@ -0,0 +1,36 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <cstddef>
+
+/*
+Each benchmark compares something from the topic folders against the std:: version
+it is meant to replace, on inputs growing up to max_size elements.
+*/
+void BenchParallelAlgorithms(size_t max_size);
+void BenchSimdCountFind(size_t max_size);
+void BenchRadixSort(size_t max_size);
+void BenchDisplay(size_t max_size);
+void BenchStaticIndex(size_t max_size);
+void BenchCompact(size_t max_size);
+void BenchPhilox(size_t max_size);
+void BenchSearchers(size_t max_size);
+void BenchStatistics(size_t max_size);
+void BenchPipeline(size_t max_size);
+void BenchPartition(size_t max_size);
+void BenchTopK(size_t max_size);
+void BenchScan(size_t max_size);
+void BenchDedup(size_t max_size);
+void BenchExternalSort(size_t max_size);
+void BenchAdaptiveSort(size_t max_size);
+void BenchSortNetwork(size_t max_size);
+void BenchHistogram(size_t max_size);
+void BenchBulkMemory(size_t max_size);
+void BenchSetOperations(size_t max_size);
+void BenchRecordStore(size_t max_size);
+void BenchPrefixSort(size_t max_size);
+void BenchIndexedRecords(size_t max_size);
+void BenchPoolList(size_t max_size);
+void BenchUnrolledList(size_t max_size);
+
+#endif
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/bulk_memory.h"
+#include "../Algorithms/simd.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+// Size of a buffer of n ints in GB per second, to compare with the memory bandwidth
+static std::string GigabytesPerSecond(size_t n, double seconds)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f GB/s", n * sizeof(int) / seconds / 1e9);
+    return text;
+}
+
+/*
+std::fill and std::copy against BulkFill and BulkCopy for every thread count, with
+normal stores (SimdLevel::Scalar) and with streaming stores at the best level the CPU
+has. Buffers below BULK_STREAMING_THRESHOLD bytes never stream, so the difference only
+shows for big sizes (try 256M, a 1 GB buffer).
+*/
+void BenchBulkMemory(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> src{RandomInts(n)};
+        std::vector<int> dst(n);
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               { std::fill(dst.begin(), dst.end(), 42); });
+        PrintResult("std::fill (" + GigabytesPerSecond(n, seconds) + ")", n, seconds);
+        seconds = SecondsToRun([&]
+                               { std::copy(src.cbegin(), src.cend(), dst.begin()); });
+        PrintResult("std::copy (" + GigabytesPerSecond(n, seconds) + ")", n, seconds);
+
+        for (unsigned threads : ThreadCounts())
+        {
+            for (SimdLevel level : {SimdLevel::Scalar, ActiveSimdLevel()})
+            {
+                std::string stores{level == SimdLevel::Scalar ? "normal" : SimdLevelName(level)};
+                std::string suffix{" (" + std::to_string(threads) + " threads, " + stores + ", "};
+                seconds = SecondsToRun([&]
+                                       { BulkFill(dst.begin(), dst.end(), 42, threads, level); });
+                PrintResult("BulkFill" + suffix + GigabytesPerSecond(n, seconds) + ")", n, seconds);
+                seconds = SecondsToRun([&]
+                                       { BulkCopy(src.cbegin(), src.cend(), dst.begin(), threads, level); });
+                PrintResult("BulkCopy" + suffix + GigabytesPerSecond(n, seconds) + ")", n, seconds);
+            }
+        }
+        bench_sink = static_cast<size_t>(dst[n / 2]);
+        std::cout << std::endl;
+    }
+}
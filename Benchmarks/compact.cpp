@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/compact.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+remove + erase, remove_if + erase, unique + erase and copy_if versus the compaction
+kernels at each level. The input has values 0-3 so about a quarter is removed by
+remove, half by remove_if (is_even), and runs are short enough that unique removes
+about a quarter, all in an unpredictable pattern.
+*/
+void BenchCompact(size_t max_size)
+{
+    auto is_even{[](int e)
+                 { return e % 2 == 0; }};
+
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> input{RandomInts(n, 0, 3)};
+        std::vector<int> vec;
+        double seconds;
+
+        vec = input;
+        seconds = SecondsToRun([&]
+                               { vec.erase(std::remove(vec.begin(), vec.end(), 2), vec.end()); });
+        PrintResult("std::remove + erase", n, seconds);
+        vec = input;
+        seconds = SecondsToRun([&]
+                               { vec.erase(std::remove_if(vec.begin(), vec.end(), is_even), vec.end()); });
+        PrintResult("std::remove_if + erase", n, seconds);
+        vec = input;
+        seconds = SecondsToRun([&]
+                               { vec.erase(std::unique(vec.begin(), vec.end()), vec.end()); });
+        PrintResult("std::unique + erase", n, seconds);
+        std::vector<int> copied;
+        copied.reserve(n);
+        seconds = SecondsToRun([&]
+                               { std::copy_if(input.cbegin(), input.cend(), std::back_inserter(copied), is_even); });
+        PrintResult("std::copy_if", n, seconds);
+
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512})
+        {
+            if (level > ActiveSimdLevel())
+            {
+                break;
+            }
+            std::string suffix{" (" + SimdLevelName(level) + ")"};
+            vec = input;
+            seconds = SecondsToRun([&]
+                                   { vec.resize(SimdRemove(vec.data(), vec.size(), 2, level)); });
+            PrintResult("SimdRemove" + suffix, n, seconds);
+            vec = input;
+            seconds = SecondsToRun([&]
+                                   { vec.resize(SimdRemoveMasked(vec.data(), vec.size(), 1, 0, level)); });
+            PrintResult("SimdRemoveMasked" + suffix, n, seconds);
+            vec = input;
+            seconds = SecondsToRun([&]
+                                   { vec.resize(SimdUnique(vec.data(), vec.size(), level)); });
+            PrintResult("SimdUnique" + suffix, n, seconds);
+            copied.resize(n);
+            seconds = SecondsToRun([&]
+                                   { copied.resize(SimdCopyIfMasked(input.data(), n, copied.data(), 1, 0, level)); });
+            PrintResult("SimdCopyIfMasked" + suffix, n, seconds);
+        }
+        bench_sink = vec.size() + copied.size();
+        std::cout << std::endl;
+    }
+}
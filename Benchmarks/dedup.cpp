@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../Algorithms/dedup.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+Removing all duplicates: sort + unique (which loses the original order), a loop keeping
+the first of each value in a std::unordered_set, HashUnique, and ParallelHashUniqueCopy
+for every thread count. Inputs are random ints where about half the elements are
+duplicates (values in [0, n)) and where almost none are (values in [0, 10^9]).
+*/
+void BenchDedup(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        for (int max : {static_cast<int>(n - 1), 1'000'000'000})
+        {
+            std::vector<int> input{RandomInts(n, 0, max)};
+            std::vector<int> output(n);
+            std::string dups{max == 1'000'000'000 ? "few dups" : "many dups"};
+            std::string suffix{" (" + dups + ")"};
+            double seconds;
+
+            output = input;
+            seconds = SecondsToRun([&]
+                                   {
+                std::sort(output.begin(), output.end());
+                bench_sink = std::unique(output.begin(), output.end()) - output.begin(); });
+            PrintResult("std::sort + std::unique" + suffix, n, seconds);
+            seconds = SecondsToRun([&]
+                                   {
+                std::unordered_set<int> seen(n);
+                bench_sink = std::copy_if(input.cbegin(), input.cend(), output.begin(), [&](int e)
+                                          { return seen.insert(e).second; }) - output.begin(); });
+            PrintResult("std::unordered_set" + suffix, n, seconds);
+            output = input;
+            seconds = SecondsToRun([&]
+                                   { bench_sink = HashUnique(output.begin(), output.end()) - output.begin(); });
+            PrintResult("HashUnique" + suffix, n, seconds);
+
+            for (unsigned threads : ThreadCounts())
+            {
+                seconds = SecondsToRun([&]
+                                       { bench_sink = ParallelHashUniqueCopy(input.cbegin(), input.cend(), output.begin(), threads) - output.begin(); });
+                PrintResult("ParallelHashUniqueCopy (" + std::to_string(threads) + " threads, " + dups + ")", n, seconds);
+            }
+        }
+        std::cout << std::endl;
+    }
+}
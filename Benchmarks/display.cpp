@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../Common/display.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+// The DisplayContainer that used to be copied into each folder, writing to out instead of cout
+template <typename T>
+void OldDisplayContainer(const T &container, std::ostream &out)
+{
+    out << "[ ";
+    for (auto itr = container.cbegin(); itr != container.cend(); itr++)
+    {
+        out << *itr << " ";
+    }
+    out << "] size = " << container.size() << std::endl;
+}
+
+template <typename T>
+void OldDisplayMap(const T &container, std::ostream &out)
+{
+    out << "[ ";
+    for (auto itr = container.cbegin(); itr != container.cend(); itr++)
+    {
+        out << "(" << itr->first << ", " << itr->second << ") ";
+    }
+    out << "] size = " << container.size() << std::endl;
+}
+
+/*
+Both versions write to the same file in the temp directory. Containers are printed in
+rows of 100 elements, since the std::endl flush per call is a big part of the old cost.
+*/
+void BenchDisplay(size_t max_size)
+{
+    std::filesystem::path path{std::filesystem::temp_directory_path() / "display_bench.txt"};
+
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> input{RandomInts(n)};
+        std::list<int> list_input(input.cbegin(), input.cend());
+        std::vector<std::vector<int>> rows;
+        for (size_t i = 0; i < n; i += 100)
+        {
+            rows.emplace_back(input.cbegin() + i, input.cbegin() + std::min(n, i + 100));
+        }
+        // Maps are slow to build, so this one only gets a tenth of the elements
+        std::map<int, std::string> map_input;
+        for (size_t i = 0; i < n / 10; i++)
+        {
+            map_input[input[i]] = "value";
+        }
+        double seconds;
+
+        {
+            std::ofstream out(path);
+            seconds = SecondsToRun([&]
+                                   { OldDisplayContainer(input, out); });
+            PrintResult("old DisplayContainer vector", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { OldDisplayContainer(list_input, out); });
+            PrintResult("old DisplayContainer list", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { for (const auto &row : rows)
+                                     {
+                                         OldDisplayContainer(row, out);
+                                     } });
+            PrintResult("old DisplayContainer rows of 100", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { OldDisplayMap(map_input, out); });
+            PrintResult("old DisplayMap", map_input.size(), seconds);
+        }
+        {
+            std::ofstream out(path);
+            OutputBuffer buffer(out);
+            seconds = SecondsToRun([&]
+                                   { DisplayContainer(input, buffer); buffer.Flush(); });
+            PrintResult("DisplayContainer vector", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { DisplayContainer(list_input, buffer); buffer.Flush(); });
+            PrintResult("DisplayContainer list", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { for (const auto &row : rows)
+                                     {
+                                         DisplayContainer(row, buffer);
+                                     }
+                                     buffer.Flush(); });
+            PrintResult("DisplayContainer rows of 100", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { DisplayMap(map_input, buffer); buffer.Flush(); });
+            PrintResult("DisplayMap", map_input.size(), seconds);
+        }
+        std::cout << std::endl;
+    }
+    std::filesystem::remove(path);
+}
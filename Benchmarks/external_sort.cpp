@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/external_sort.h"
+#include "../Algorithms/parallel.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+Sorting a file of random ints: reading the whole file, ParallelSort and writing it back
+(what to do when it fits in memory), then ExternalSort with budgets of the whole input
+and of 1/16 and 1/256 of it, which make more runs to merge. The ExternalSort rows also
+show the bytes read plus written per second from its counters, which shows how close
+to the disk's sequential speed it gets. Files go in the system temp
+directory, where the OS will usually keep them cached when they're this small.
+*/
+void BenchExternalSort(size_t max_size)
+{
+    std::filesystem::path input_path{std::filesystem::temp_directory_path() / "bench_external_sort_in.bin"};
+    std::filesystem::path output_path{std::filesystem::temp_directory_path() / "bench_external_sort_out.bin"};
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> input{RandomInts(n)};
+        {
+            std::ofstream file(input_path, std::ios_base::binary);
+            file.write(reinterpret_cast<const char *>(input.data()), static_cast<std::streamsize>(n * sizeof(int)));
+        }
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               {
+            std::vector<int> records(n);
+            std::ifstream in(input_path, std::ios_base::binary);
+            in.read(reinterpret_cast<char *>(records.data()), static_cast<std::streamsize>(n * sizeof(int)));
+            ParallelSort(records.begin(), records.end());
+            std::ofstream out(output_path, std::ios_base::binary);
+            out.write(reinterpret_cast<const char *>(records.data()), static_cast<std::streamsize>(n * sizeof(int)));
+            bench_sink = records[n / 2]; });
+        PrintResult("read + ParallelSort + write", n, seconds);
+
+        for (size_t divisor : {1, 16, 256})
+        {
+            ExternalSortOptions options;
+            options.memory_budget = std::max<size_t>(n * sizeof(int) / divisor, 4096);
+            options.io_buffer_size = std::min<size_t>(options.io_buffer_size, options.memory_budget / 32);
+            ExternalSortStats stats;
+            seconds = SecondsToRun([&]
+                                   { stats = ExternalSort<int>(input_path, output_path, options); });
+            std::string throughput{std::to_string(static_cast<int>(stats.ThroughputMBPerSecond())) + " MB/s"};
+            PrintResult("ExternalSort (n/" + std::to_string(divisor) + ", " + std::to_string(stats.runs) + " runs, " + throughput + ")", n, seconds);
+        }
+        std::cout << std::endl;
+    }
+    std::filesystem::remove(input_path);
+    std::filesystem::remove(output_path);
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Algorithms/histogram.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+Counting every distinct value: one std::count pass per value (only for the byte keys,
+where there are 256 values), a std::unordered_map, then DenseHistogram and
+SparseHistogram for every thread count. Keys are random ints in [0, 255] (bytes),
+[0, 65535] (small ids) and [0, 10^9] (nearly all distinct), DenseHistogram only runs
+on the first two.
+*/
+void BenchHistogram(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        for (int max : {255, 65'535, 1'000'000'000})
+        {
+            std::vector<int> input{RandomInts(n, 0, max)};
+            std::string keys{max == 255 ? "bytes" : max == 65'535 ? "16 bit" : "sparse"};
+            double seconds;
+
+            if (max == 255)
+            {
+                seconds = SecondsToRun([&]
+                                       {
+                    for (int key = 0; key <= max; key++)
+                    {
+                        bench_sink = std::count(input.cbegin(), input.cend(), key);
+                    } });
+                PrintResult("std::count per value (" + keys + ")", n, seconds);
+            }
+            seconds = SecondsToRun([&]
+                                   {
+                std::unordered_map<int, size_t> counts;
+                for (int e : input)
+                {
+                    counts[e]++;
+                }
+                bench_sink = counts.size(); });
+            PrintResult("std::unordered_map (" + keys + ")", n, seconds);
+
+            for (unsigned threads : ThreadCounts())
+            {
+                std::string suffix{" (" + std::to_string(threads) + " threads, " + keys + ")"};
+                if (max != 1'000'000'000)
+                {
+                    seconds = SecondsToRun([&]
+                                           { bench_sink = DenseHistogram(input.cbegin(), input.cend(), 0, max, threads)[0]; });
+                    PrintResult("DenseHistogram" + suffix, n, seconds);
+                }
+                seconds = SecondsToRun([&]
+                                       { bench_sink = SparseHistogram(input.cbegin(), input.cend(), threads).size(); });
+                PrintResult("SparseHistogram" + suffix, n, seconds);
+            }
+        }
+        std::cout << std::endl;
+    }
+}
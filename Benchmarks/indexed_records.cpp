@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "../Lists/indexed_records.h"
+#include "../Lists/record.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+// Number of lookups and removals timed per size, the list versions take O(n) each
+constexpr size_t INDEXED_RECORDS_OPERATIONS{100};
+
+/*
+A std::list<Record> against IndexedRecords: building from n names (8 to 24 random
+letters) and phone numbers (distinct), then INDEXED_RECORDS_OPERATIONS lookups by phone
+number (std::find_if against FindByPhoneNumber) and removals by name (list::remove with
+a dummy Record against EraseByName). The looked up keys are spread through the list.
+All rows are in records per second of the n being built or searched.
+*/
+void BenchIndexedRecords(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<std::string> names{RandomStrings(n, 8, 24)};
+        std::vector<std::string> phone_numbers(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            phone_numbers[i] = "555-" + std::to_string(10'000'000 + i).substr(1);
+        }
+        std::vector<size_t> picks;
+        for (size_t i = 0; i < INDEXED_RECORDS_OPERATIONS; i++)
+        {
+            picks.push_back(i * n / INDEXED_RECORDS_OPERATIONS);
+        }
+        double seconds;
+
+        std::list<Record> list;
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i = 0; i < n; i++)
+            {
+                list.push_back(Record(names[i], phone_numbers[i]));
+            } });
+        PrintResult("std::list<Record> build", n, seconds);
+        IndexedRecords indexed;
+        seconds = SecondsToRun([&]
+                               {
+            indexed.reserve(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                indexed.Insert(names[i], phone_numbers[i]);
+            } });
+        PrintResult("IndexedRecords build", n, seconds);
+
+        std::string suffix{" (" + std::to_string(INDEXED_RECORDS_OPERATIONS) + " keys)"};
+        seconds = SecondsToRun([&]
+                               {
+            size_t found{0};
+            for (size_t i : picks)
+            {
+                found += std::find_if(list.cbegin(), list.cend(), [&](const Record &r)
+                                      { return r.PhoneNumber() == phone_numbers[i]; }) != list.cend();
+            }
+            bench_sink = found; });
+        PrintResult("std::find_if by phone number" + suffix, n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            size_t found{0};
+            for (size_t i : picks)
+            {
+                found += indexed.FindByPhoneNumber(phone_numbers[i]) != nullptr;
+            }
+            bench_sink = found; });
+        PrintResult("FindByPhoneNumber" + suffix, n, seconds);
+
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i : picks)
+            {
+                list.remove(Record(names[i], ""));
+            } });
+        PrintResult("list::remove by name" + suffix, n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i : picks)
+            {
+                indexed.EraseByName(names[i]);
+            } });
+        PrintResult("EraseByName" + suffix, n, seconds);
+        bench_sink = list.size() + indexed.size();
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "benchmarks.h"
+
+/*
+Unlike the other folders, this needs to be built with optimizations (-O2 instead of -g,
+see .vscode/tasks.json), timings of unoptimized builds don't mean much.
+
+Usage: rooster.exe [benchmark name or all] [max input size]
+*/
+int main(int argc, char *argv[])
+{
+    // vector of pairs not map so that "all" runs them in the order listed here
+    std::vector<std::pair<std::string, void (*)(size_t)>> benchmarks{
+        {"parallel", BenchParallelAlgorithms},
+        {"simd", BenchSimdCountFind},
+        {"radix", BenchRadixSort},
+        {"display", BenchDisplay},
+        {"index", BenchStaticIndex},
+        {"compact", BenchCompact},
+        {"philox", BenchPhilox},
+        {"search", BenchSearchers},
+        {"stats", BenchStatistics},
+        {"pipeline", BenchPipeline},
+        {"partition", BenchPartition},
+        {"topk", BenchTopK},
+        {"scan", BenchScan},
+        {"dedup", BenchDedup},
+        {"extsort", BenchExternalSort},
+        {"adaptive", BenchAdaptiveSort},
+        {"network", BenchSortNetwork},
+        {"histogram", BenchHistogram},
+        {"bulk", BenchBulkMemory},
+        {"setops", BenchSetOperations},
+        {"records", BenchRecordStore},
+        {"prefixsort", BenchPrefixSort},
+        {"indexed", BenchIndexedRecords},
+        {"poollist", BenchPoolList},
+        {"unrolled", BenchUnrolledList},
+    };
+
+    std::string name{argc > 1 ? argv[1] : "all"};
+    size_t max_size{argc > 2 ? std::stoull(argv[2]) : size_t{1} << 24};
+
+    bool found{false};
+    for (const auto &[bench_name, bench] : benchmarks)
+    {
+        if (name == "all" || name == bench_name)
+        {
+            std::cout << "== " << bench_name << " ==" << std::endl;
+            bench(max_size);
+            found = true;
+        }
+    }
+    if (!found)
+    {
+        std::cout << "Unknown benchmark " << name << ", choose from: all";
+        for (const auto &benchmark : benchmarks)
+        {
+            std::cout << " " << benchmark.first;
+        }
+        std::cout << std::endl;
+        return 1;
+    }
+    return 0;
+}
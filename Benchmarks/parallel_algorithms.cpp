@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/parallel.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+Sequential std:: calls versus the Parallel* versions for every thread count,
+each run on a fresh copy of the same random input.
+*/
+void BenchParallelAlgorithms(size_t max_size)
+{
+    auto is_even{[](int e)
+                 { return e % 2 == 0; }};
+    // Inputs are never negative, so finds scan the whole range
+    auto is_negative{[](int e)
+                     { return e < 0; }};
+    auto negate{[](int e)
+                { return -e; }};
+
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> input{RandomInts(n)};
+        std::vector<int> output(n);
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::find_if(input.cbegin(), input.cend(), is_negative) - input.cbegin(); });
+        PrintResult("std::find_if", n, seconds);
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::count_if(input.cbegin(), input.cend(), is_even); });
+        PrintResult("std::count_if", n, seconds);
+        seconds = SecondsToRun([&]
+                               { std::transform(input.cbegin(), input.cend(), output.begin(), negate); });
+        PrintResult("std::transform", n, seconds);
+        output = input;
+        seconds = SecondsToRun([&]
+                               { std::replace_if(output.begin(), output.end(), is_even, 0); });
+        PrintResult("std::replace_if", n, seconds);
+        output = input;
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::partition(output.begin(), output.end(), is_even) - output.begin(); });
+        PrintResult("std::partition", n, seconds);
+        output = input;
+        seconds = SecondsToRun([&]
+                               { std::sort(output.begin(), output.end()); });
+        PrintResult("std::sort", n, seconds);
+
+        for (unsigned threads : ThreadCounts())
+        {
+            std::string suffix{" (" + std::to_string(threads) + " threads)"};
+            seconds = SecondsToRun([&]
+                                   { bench_sink = ParallelFindIf(input.cbegin(), input.cend(), is_negative, threads) - input.cbegin(); });
+            PrintResult("ParallelFindIf" + suffix, n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = ParallelCountIf(input.cbegin(), input.cend(), is_even, threads); });
+            PrintResult("ParallelCountIf" + suffix, n, seconds);
+            seconds = SecondsToRun([&]
+                                   { ParallelTransform(input.cbegin(), input.cend(), output.begin(), negate, threads); });
+            PrintResult("ParallelTransform" + suffix, n, seconds);
+            output = input;
+            seconds = SecondsToRun([&]
+                                   { ParallelReplaceIf(output.begin(), output.end(), is_even, 0, threads); });
+            PrintResult("ParallelReplaceIf" + suffix, n, seconds);
+            output = input;
+            seconds = SecondsToRun([&]
+                                   { bench_sink = ParallelPartition(output.begin(), output.end(), is_even, threads) - output.begin(); });
+            PrintResult("ParallelPartition" + suffix, n, seconds);
+            output = input;
+            seconds = SecondsToRun([&]
+                                   { ParallelSort(output.begin(), output.end(), std::less<int>(), threads); });
+            PrintResult("ParallelSort" + suffix, n, seconds);
+        }
+        std::cout << std::endl;
+    }
+}
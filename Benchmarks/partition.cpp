@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/parallel.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+std::partition and std::stable_partition versus the parallel versions, with thread
+counts from 1 to 64 regardless of how many cores there are (past that the threads
+just take turns, which shows what oversubscribing costs). The predicate is is_even
+on random ints so it's true about half the time in no pattern.
+*/
+void BenchPartition(size_t max_size)
+{
+    constexpr unsigned MAX_THREADS{64};
+    auto is_even{[](int e)
+                 { return e % 2 == 0; }};
+
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> input{RandomInts(n)};
+        std::vector<int> output(input);
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::partition(output.begin(), output.end(), is_even) - output.begin(); });
+        PrintResult("std::partition", n, seconds);
+        output = input;
+        seconds = SecondsToRun([&]
+                               { bench_sink = BlockPartition(output.begin(), output.end(), is_even) - output.begin(); });
+        PrintResult("BlockPartition", n, seconds);
+        output = input;
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::stable_partition(output.begin(), output.end(), is_even) - output.begin(); });
+        PrintResult("std::stable_partition", n, seconds);
+        output = input;
+        seconds = SecondsToRun([&]
+                               { bench_sink = BufferedStablePartition(output.begin(), output.end(), is_even) - output.begin(); });
+        PrintResult("BufferedStablePartition", n, seconds);
+
+        for (unsigned threads = 1; threads <= MAX_THREADS; threads *= 2)
+        {
+            std::string suffix{" (" + std::to_string(threads) + " threads)"};
+            output = input;
+            seconds = SecondsToRun([&]
+                                   { bench_sink = ParallelPartition(output.begin(), output.end(), is_even, threads) - output.begin(); });
+            PrintResult("ParallelPartition" + suffix, n, seconds);
+            output = input;
+            seconds = SecondsToRun([&]
+                                   { bench_sink = ParallelStablePartition(output.begin(), output.end(), is_even, threads) - output.begin(); });
+            PrintResult("ParallelStablePartition" + suffix, n, seconds);
+        }
+        std::cout << std::endl;
+    }
+}
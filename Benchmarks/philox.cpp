@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/philox.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+std::generate with rand and with a Mersenne Twister distribution versus the Philox
+fills, for uniform ints in [0, 999] and doubles in [0, 1).
+*/
+void BenchPhilox(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> ints(n);
+        std::vector<double> doubles(n);
+        double seconds;
+
+        srand(42);
+        seconds = SecondsToRun([&]
+                               { std::generate(ints.begin(), ints.end(), []
+                                               { return rand() % 1000; }); });
+        PrintResult("std::generate rand() % 1000", n, seconds);
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> int_dist(0, 999);
+        seconds = SecondsToRun([&]
+                               { std::generate(ints.begin(), ints.end(), [&]
+                                               { return int_dist(gen); }); });
+        PrintResult("std::generate mt19937 ints", n, seconds);
+        std::uniform_real_distribution<double> double_dist(0.0, 1.0);
+        seconds = SecondsToRun([&]
+                               { std::generate(doubles.begin(), doubles.end(), [&]
+                                               { return double_dist(gen); }); });
+        PrintResult("std::generate mt19937 doubles", n, seconds);
+        PhiloxEngine engine(42);
+        seconds = SecondsToRun([&]
+                               { std::generate(ints.begin(), ints.end(), [&]
+                                               { return int_dist(engine); }); });
+        PrintResult("std::generate PhiloxEngine ints", n, seconds);
+
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2})
+        {
+            if (level > ActiveSimdLevel())
+            {
+                break;
+            }
+            for (unsigned threads : ThreadCounts())
+            {
+                std::string suffix{" (" + SimdLevelName(level) + ", " + std::to_string(threads) + " threads)"};
+                seconds = SecondsToRun([&]
+                                       { PhiloxFillInts(ints.data(), n, 0, 999, 42, 0, threads, level); });
+                PrintResult("PhiloxFillInts" + suffix, n, seconds);
+                seconds = SecondsToRun([&]
+                                       { PhiloxFillDoubles(doubles.data(), n, 42, 0, threads, level); });
+                PrintResult("PhiloxFillDoubles" + suffix, n, seconds);
+            }
+        }
+        bench_sink = ints.back() + static_cast<size_t>(doubles.back() * 1000);
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/pipeline.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+The same 3, 4 and 5 stage pipelines written as one std:: call per stage, each filling
+a new intermediate vector (as chained transforms do now), versus one lazy Pipeline.
+Stages: times 3, add a second vector, abs, keep the evens, halve, and the 5 stage one
+ends with a sum instead of a vector.
+*/
+void BenchPipeline(size_t max_size)
+{
+    auto times3{[](int e)
+                { return e * 3; }};
+    auto abs{[](int e)
+             { return std::abs(e); }};
+    auto is_even{[](int e)
+                 { return e % 2 == 0; }};
+    auto halve{[](int e)
+               { return e / 2; }};
+
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> a{RandomInts(n, -1'000'000, 1'000'000, 1)};
+        std::vector<int> b{RandomInts(n, -1'000'000, 1'000'000, 2)};
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               {
+            std::vector<int> step1(n), step2(n), step3(n);
+            std::transform(a.cbegin(), a.cend(), step1.begin(), times3);
+            std::transform(step1.cbegin(), step1.cend(), b.cbegin(), step2.begin(), std::plus<int>());
+            std::transform(step2.cbegin(), step2.cend(), step3.begin(), abs);
+            bench_sink = step3.back(); });
+        PrintResult("std::transform x3", n, seconds);
+        seconds = SecondsToRun([&]
+                               { bench_sink = Lazy(a).Map(times3).Zip(b, std::plus<int>()).Map(abs).ToVector().back(); });
+        PrintResult("Pipeline 3 stages", n, seconds);
+
+        seconds = SecondsToRun([&]
+                               {
+            std::vector<int> step1(n), step2(n), step3(n), step4;
+            std::transform(a.cbegin(), a.cend(), step1.begin(), times3);
+            std::transform(step1.cbegin(), step1.cend(), b.cbegin(), step2.begin(), std::plus<int>());
+            std::transform(step2.cbegin(), step2.cend(), step3.begin(), abs);
+            std::copy_if(step3.cbegin(), step3.cend(), std::back_inserter(step4), is_even);
+            bench_sink = step4.size(); });
+        PrintResult("std::transform x3 + copy_if", n, seconds);
+        seconds = SecondsToRun([&]
+                               { bench_sink = Lazy(a).Map(times3).Zip(b, std::plus<int>()).Map(abs).Filter(is_even).ToVector().size(); });
+        PrintResult("Pipeline 4 stages", n, seconds);
+
+        seconds = SecondsToRun([&]
+                               {
+            std::vector<int> step1(n), step2(n), step3(n), step4;
+            std::transform(a.cbegin(), a.cend(), step1.begin(), times3);
+            std::transform(step1.cbegin(), step1.cend(), b.cbegin(), step2.begin(), std::plus<int>());
+            std::transform(step2.cbegin(), step2.cend(), step3.begin(), abs);
+            std::copy_if(step3.cbegin(), step3.cend(), std::back_inserter(step4), is_even);
+            std::transform(step4.cbegin(), step4.cend(), step4.begin(), halve);
+            bench_sink = std::accumulate(step4.cbegin(), step4.cend(), 0L); });
+        PrintResult("std::transform x3 + copy_if + transform + sum", n, seconds);
+        seconds = SecondsToRun([&]
+                               { bench_sink = Lazy(a).Map(times3).Zip(b, std::plus<int>()).Map(abs).Filter(is_even).Map(halve).Reduce(0L); });
+        PrintResult("Pipeline 5 stages + sum", n, seconds);
+        std::cout << std::endl;
+    }
+}
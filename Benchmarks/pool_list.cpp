@@ -0,0 +1,115 @@
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Lists/pool_list.h"
+#include "../Lists/record.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+// Calls to allocate made through CountingAllocator, i.e. std::list's node allocations
+static size_t node_allocations{0};
+
+template <typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &) {}
+
+    T *allocate(size_t n)
+    {
+        node_allocations++;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U> &) const
+    {
+        return true;
+    }
+};
+
+// Sum of every name's length, a walk over the whole list that has to touch each element
+template <typename List>
+size_t NameLengths(const List &list)
+{
+    size_t total{0};
+    for (const Record &record : list)
+    {
+        total += record.Name().size();
+    }
+    return total;
+}
+
+/*
+std::list<Record> against PoolList<Record>: building with push_back (with how many node
+allocations each made, the Records' own strings aren't counted), walking the list in
+the order it was built, sorting by name, walking again in sorted order (now jumping
+around memory in both), then destroying it. Names are 8 to 24 random letters. Building
+and destroying are mostly the Records' own strings (two or three mallocs each against the
+one node allocation saved) and how warm malloc's free lists are from the run before, so
+for those the allocation counts are the point.
+*/
+void BenchPoolList(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<std::string> names{RandomStrings(n, 8, 24)};
+        double seconds;
+        {
+            auto list{std::make_unique<std::list<Record, CountingAllocator<Record>>>()};
+            node_allocations = 0;
+            seconds = SecondsToRun([&]
+                                   {
+                for (size_t i = 0; i < n; i++)
+                {
+                    list->push_back(Record(names[i], "555-0100"));
+                } });
+            PrintResult("std::list build (" + std::to_string(node_allocations) + " allocations)", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = NameLengths(*list); });
+            PrintResult("std::list walk", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { list->sort(); });
+            PrintResult("std::list sort", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = NameLengths(*list); });
+            PrintResult("std::list walk (sorted)", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { list.reset(); });
+            PrintResult("std::list destroy", n, seconds);
+        }
+        {
+            auto list{std::make_unique<PoolList<Record>>()};
+            seconds = SecondsToRun([&]
+                                   {
+                for (size_t i = 0; i < n; i++)
+                {
+                    list->push_back(Record(names[i], "555-0100"));
+                } });
+            PrintResult("PoolList build (" + std::to_string(list->slab_count()) + " allocations)", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = NameLengths(*list); });
+            PrintResult("PoolList walk", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { list->sort(); });
+            PrintResult("PoolList sort", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = NameLengths(*list); });
+            PrintResult("PoolList walk (sorted)", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { list.reset(); });
+            PrintResult("PoolList destroy", n, seconds);
+        }
+        std::cout << std::endl;
+    }
+}
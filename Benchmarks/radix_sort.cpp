@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../Algorithms/radix_sort.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+// Random keys over the whole range of Key, so every radix pass has work to do
+template <typename Key>
+std::vector<Key> RandomKeys(size_t n)
+{
+    std::mt19937_64 gen(42);
+    std::vector<Key> keys(n);
+    for (auto &key : keys)
+    {
+        key = static_cast<Key>(gen());
+    }
+    return keys;
+}
+
+template <typename Key>
+void BenchRadixSortKeys(const std::string &type_name, size_t n)
+{
+    std::vector<Key> input{RandomKeys<Key>(n)};
+    std::vector<Key> keys;
+    double seconds;
+
+    keys = input;
+    seconds = SecondsToRun([&]
+                           { std::sort(keys.begin(), keys.end()); });
+    PrintResult("std::sort " + type_name, n, seconds);
+    keys = input;
+    seconds = SecondsToRun([&]
+                           { RadixSort(keys.begin(), keys.end()); });
+    PrintResult("RadixSort " + type_name, n, seconds);
+    keys = input;
+    seconds = SecondsToRun([&]
+                           { std::sort(keys.begin(), keys.end(), std::greater<Key>()); });
+    PrintResult("std::sort greater " + type_name, n, seconds);
+    keys = input;
+    seconds = SecondsToRun([&]
+                           { RadixSort(keys.begin(), keys.end(), true); });
+    PrintResult("RadixSort descending " + type_name, n, seconds);
+
+    // Payload version versus the usual way of sorting keys with payloads: a vector of pairs
+    std::vector<std::pair<Key, uint32_t>> pairs(n);
+    std::vector<uint32_t> values(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        pairs[i] = {input[i], static_cast<uint32_t>(i)};
+        values[i] = static_cast<uint32_t>(i);
+    }
+    seconds = SecondsToRun([&]
+                           { std::sort(pairs.begin(), pairs.end(), [](const auto &lhs, const auto &rhs)
+                                       { return lhs.first < rhs.first; }); });
+    PrintResult("std::sort pairs " + type_name, n, seconds);
+    keys = input;
+    seconds = SecondsToRun([&]
+                           { RadixSortByKey(keys.begin(), keys.end(), values.begin()); });
+    PrintResult("RadixSortByKey " + type_name, n, seconds);
+}
+
+void BenchRadixSort(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size, 16, 8))
+    {
+        BenchRadixSortKeys<int32_t>("int32", n);
+        BenchRadixSortKeys<uint32_t>("uint32", n);
+        BenchRadixSortKeys<int64_t>("int64", n);
+        BenchRadixSortKeys<uint64_t>("uint64", n);
+        std::cout << std::endl;
+    }
+}
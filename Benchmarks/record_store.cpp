@@ -0,0 +1,85 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../Lists/record.h"
+#include "../Lists/record_store.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+// Bytes per record, to go in a row name
+static std::string BytesPerRecord(double bytes)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.0f B/record", bytes);
+    return text;
+}
+
+/*
+Building n records as a std::vector<Record> and as a RecordStore, then reading every
+record's display form: Record's operator const char * against RecordStore::Display into
+one reused buffer. Names are 8 to 24 random letters (so most don't fit in a small string,
+and no display does), phone numbers are "555-" and 7 digits. The memory each layout takes
+per record is in the build rows.
+*/
+void BenchRecordStore(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<std::string> names{RandomStrings(n, 8, 24)};
+        std::vector<std::string> phone_numbers(n);
+        std::vector<int> digits{RandomInts(n, 0, 9'999'999)};
+        for (size_t i = 0; i < n; i++)
+        {
+            phone_numbers[i] = "555-" + std::to_string(10'000'000 + digits[i]).substr(1);
+        }
+        double seconds;
+
+        std::vector<Record> records;
+        seconds = SecondsToRun([&]
+                               {
+            records.reserve(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                records.emplace_back(names[i], phone_numbers[i]);
+            } });
+        size_t record_bytes{0};
+        for (const Record &record : records)
+        {
+            record_bytes += record.MemoryUsage();
+        }
+        PrintResult("std::vector<Record> build (" + BytesPerRecord(static_cast<double>(record_bytes) / n) + ")", n, seconds);
+
+        RecordStore store;
+        seconds = SecondsToRun([&]
+                               {
+            store.reserve(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                store.Add(names[i], phone_numbers[i]);
+            } });
+        PrintResult("RecordStore build (" + BytesPerRecord(store.BytesPerRecord()) + ")", n, seconds);
+
+        seconds = SecondsToRun([&]
+                               {
+            size_t total{0};
+            for (const Record &record : records)
+            {
+                total += std::strlen(record);
+            }
+            bench_sink = total; });
+        PrintResult("Record display", n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            char buffer[64];
+            size_t total{0};
+            for (size_t i = 0; i < store.size(); i++)
+            {
+                total += std::strlen(store.Display(i, buffer, sizeof(buffer)));
+            }
+            bench_sink = total; });
+        PrintResult("RecordStore::Display", n, seconds);
+        std::cout << std::endl;
+    }
+}
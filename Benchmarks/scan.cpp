@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/scan.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+std::inclusive_scan and std::exclusive_scan (and a plain loop for the segmented scan,
+which has no std:: version) versus the SIMD kernels at every level this CPU supports on
+one thread, and then the Parallel* versions for every thread count. About 1 in 64
+elements starts a segment.
+*/
+void BenchScan(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> input{RandomInts(n, -1000, 1000)};
+        std::vector<uint8_t> flags(n);
+        std::vector<int> coin{RandomInts(n, 0, 63, 7)};
+        std::transform(coin.cbegin(), coin.cend(), flags.begin(), [](int e)
+                       { return e == 0; });
+        std::vector<int> output(n);
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               { std::inclusive_scan(input.cbegin(), input.cend(), output.begin()); });
+        PrintResult("std::inclusive_scan", n, seconds);
+        seconds = SecondsToRun([&]
+                               { std::exclusive_scan(input.cbegin(), input.cend(), output.begin(), 0); });
+        PrintResult("std::exclusive_scan", n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            int sum{0};
+            for (size_t i = 0; i < n; i++)
+            {
+                sum = flags[i] ? input[i] : sum + input[i];
+                output[i] = sum;
+            } });
+        PrintResult("segmented inclusive scan loop", n, seconds);
+        bench_sink = static_cast<size_t>(output.back());
+
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512})
+        {
+            if (level > ActiveSimdLevel())
+            {
+                break;
+            }
+            std::string suffix{" (" + SimdLevelName(level) + ")"};
+            seconds = SecondsToRun([&]
+                                   { bench_sink = static_cast<size_t>(SimdScanInts<false, false>(input.data(), nullptr, n, output.data(), 0, level)); });
+            PrintResult("SimdScanInts inclusive" + suffix, n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = static_cast<size_t>(SimdScanInts<true, false>(input.data(), nullptr, n, output.data(), 0, level)); });
+            PrintResult("SimdScanInts exclusive" + suffix, n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = static_cast<size_t>(SimdScanInts<false, true>(input.data(), flags.data(), n, output.data(), 0, level)); });
+            PrintResult("SimdScanInts segmented inclusive" + suffix, n, seconds);
+        }
+
+        for (unsigned threads : ThreadCounts())
+        {
+            std::string suffix{" (" + std::to_string(threads) + " threads)"};
+            seconds = SecondsToRun([&]
+                                   { ParallelInclusiveScan(input.cbegin(), input.cend(), output.begin(), threads); });
+            PrintResult("ParallelInclusiveScan" + suffix, n, seconds);
+            seconds = SecondsToRun([&]
+                                   { ParallelExclusiveScan(input.cbegin(), input.cend(), output.begin(), 0, threads); });
+            PrintResult("ParallelExclusiveScan" + suffix, n, seconds);
+            seconds = SecondsToRun([&]
+                                   { ParallelSegmentedInclusiveScan(input.cbegin(), input.cend(), flags.cbegin(), output.begin(), threads); });
+            PrintResult("ParallelSegmentedInclusiveScan" + suffix, n, seconds);
+        }
+        std::cout << std::endl;
+    }
+}
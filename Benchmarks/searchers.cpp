@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/searchers.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+// Runs search (returning the match position) over every haystack, reporting elements searched per second
+template <typename Haystack, typename Search>
+void BenchSearch(const std::string &name, const std::vector<Haystack> &haystacks, Search search)
+{
+    size_t total{0};
+    for (const auto &haystack : haystacks)
+    {
+        total += haystack.size();
+    }
+    double seconds{SecondsToRun([&]
+                                {
+        for (const auto &haystack : haystacks)
+        {
+            bench_sink = search(haystack);
+        } })};
+    PrintResult(name, total, seconds);
+}
+
+/*
+The needle is only at the end of each haystack, so every search scans it all. The ints
+are random in [0, 999], the bytes are lowercase letters (a small alphabet makes byte
+searching harder), and the search_n haystacks are half 0s, in runs much shorter than the
+run being looked for.
+*/
+void BenchSearchers(size_t max_size)
+{
+    constexpr size_t NUM_HAYSTACKS{8};
+    for (size_t n : InputSizes(max_size, 1 << 10, 16))
+    {
+        std::vector<int> needle{RandomInts(8, 0, 999, 1)};
+        std::vector<std::vector<int>> haystacks;
+        std::vector<std::string> byte_haystacks;
+        std::vector<std::vector<int>> run_haystacks;
+        std::string byte_needle{"abracadabra"};
+        for (size_t h = 0; h < NUM_HAYSTACKS; h++)
+        {
+            haystacks.push_back(RandomInts(n, 0, 999, static_cast<unsigned>(h)));
+            std::copy(needle.cbegin(), needle.cend(), haystacks.back().end() - std::min(n, needle.size()));
+            std::string bytes(n, 'a');
+            std::vector<int> letters{RandomInts(n, 0, 25, static_cast<unsigned>(h))};
+            std::transform(letters.cbegin(), letters.cend(), bytes.begin(), [](int e)
+                           { return static_cast<char>('a' + e); });
+            std::copy(byte_needle.cbegin(), byte_needle.cend(), bytes.end() - std::min(n, byte_needle.size()));
+            byte_haystacks.push_back(std::move(bytes));
+            std::vector<int> runs{RandomInts(n, 0, 9, static_cast<unsigned>(h))};
+            std::replace_if(runs.begin(), runs.end(), [](int e)
+                            { return e < 5; }, 0);
+            run_haystacks.push_back(std::move(runs));
+        }
+        std::string suffix{" n=" + std::to_string(n)};
+
+        BenchSearch("std::search ints" + suffix, haystacks, [&](const std::vector<int> &haystack)
+                    { return std::search(haystack.cbegin(), haystack.cend(), needle.cbegin(), needle.cend()) - haystack.cbegin(); });
+        std::boyer_moore_horspool_searcher std_horspool(needle.cbegin(), needle.cend());
+        BenchSearch("std::boyer_moore_horspool ints" + suffix, haystacks, [&](const std::vector<int> &haystack)
+                    { return std::search(haystack.cbegin(), haystack.cend(), std_horspool) - haystack.cbegin(); });
+        HorspoolSearcher<int> horspool(needle.cbegin(), needle.cend());
+        BenchSearch("HorspoolSearcher ints" + suffix, haystacks, [&](const std::vector<int> &haystack)
+                    { return horspool(haystack.cbegin(), haystack.cend()).first - haystack.cbegin(); });
+        TwoWaySearcher<int> two_way(needle.cbegin(), needle.cend());
+        BenchSearch("TwoWaySearcher ints" + suffix, haystacks, [&](const std::vector<int> &haystack)
+                    { return two_way(haystack.cbegin(), haystack.cend()).first - haystack.cbegin(); });
+
+        BenchSearch("std::search bytes" + suffix, byte_haystacks, [&](const std::string &haystack)
+                    { return std::search(haystack.cbegin(), haystack.cend(), byte_needle.cbegin(), byte_needle.cend()) - haystack.cbegin(); });
+        HorspoolSearcher<char> byte_horspool(byte_needle.cbegin(), byte_needle.cend());
+        BenchSearch("HorspoolSearcher bytes" + suffix, byte_haystacks, [&](const std::string &haystack)
+                    { return byte_horspool(haystack.cbegin(), haystack.cend()).first - haystack.cbegin(); });
+        TwoWaySearcher<char> byte_two_way(byte_needle.cbegin(), byte_needle.cend());
+        BenchSearch("TwoWaySearcher bytes" + suffix, byte_haystacks, [&](const std::string &haystack)
+                    { return byte_two_way(haystack.cbegin(), haystack.cend()).first - haystack.cbegin(); });
+
+        BenchSearch("std::search_n 0 x 32" + suffix, run_haystacks, [&](const std::vector<int> &haystack)
+                    { return std::search_n(haystack.cbegin(), haystack.cend(), 32, 0) - haystack.cbegin(); });
+        BenchSearch("RunSearchN 0 x 32" + suffix, run_haystacks, [&](const std::vector<int> &haystack)
+                    { return RunSearchN(haystack.cbegin(), haystack.cend(), 32, 0) - haystack.cbegin(); });
+        // 9 is only a tenth of the elements, so most probes miss and skip 32 elements
+        BenchSearch("std::search_n 9 x 32" + suffix, run_haystacks, [&](const std::vector<int> &haystack)
+                    { return std::search_n(haystack.cbegin(), haystack.cend(), 32, 9) - haystack.cbegin(); });
+        BenchSearch("RunSearchN 9 x 32" + suffix, run_haystacks, [&](const std::vector<int> &haystack)
+                    { return RunSearchN(haystack.cbegin(), haystack.cend(), 32, 9) - haystack.cbegin(); });
+        std::cout << std::endl;
+    }
+}
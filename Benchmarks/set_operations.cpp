@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Algorithms/set_operations.h"
+#include "../Algorithms/simd.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+// count random ints in [0, max], sorted with the repeats removed
+static std::vector<int> RandomSet(size_t count, int max, unsigned seed)
+{
+    std::vector<int> set{RandomInts(count, 0, max, seed)};
+    std::sort(set.begin(), set.end());
+    set.erase(std::unique(set.begin(), set.end()), set.end());
+    return set;
+}
+
+/*
+The std:: set operations against SortedIntersection, SortedUnion and SortedDifference,
+then a join of (key, payload) pairs: MergeJoin against an std::equal_range per key of
+the first range. n is the size of both ranges together, either two halves with about a
+third of their values in common ("similar"), or a range of n / 1000 against the rest
+("skewed", where the Sorted versions gallop). The intersection of similar ranges runs at
+every SIMD level, and the parallel versions for every thread count.
+*/
+void BenchSetOperations(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        for (bool skewed : {false, true})
+        {
+            size_t n1{skewed ? std::max<size_t>(1, n / 1000) : n / 2};
+            int max{static_cast<int>(n)};
+            std::vector<int> small{RandomSet(n1, max, 1)};
+            std::vector<int> big{RandomSet(n - n1, max, 2)};
+            std::vector<int> out(small.size() + big.size());
+            std::string shape{skewed ? "skewed" : "similar"};
+            double seconds;
+
+            seconds = SecondsToRun([&]
+                                   { bench_sink = std::set_intersection(small.cbegin(), small.cend(), big.cbegin(), big.cend(), out.begin()) - out.begin(); });
+            PrintResult("std::set_intersection (" + shape + ")", n, seconds);
+            for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512})
+            {
+                if (level > ActiveSimdLevel() || (skewed && level != SimdLevel::Scalar))
+                {
+                    continue;
+                }
+                seconds = SecondsToRun([&]
+                                       { bench_sink = SortedIntersection(small.cbegin(), small.cend(), big.cbegin(), big.cend(), out.begin(), std::less<>(), level) - out.begin(); });
+                PrintResult("SortedIntersection (" + shape + ", " + SimdLevelName(level) + ")", n, seconds);
+            }
+            seconds = SecondsToRun([&]
+                                   { bench_sink = std::set_union(small.cbegin(), small.cend(), big.cbegin(), big.cend(), out.begin()) - out.begin(); });
+            PrintResult("std::set_union (" + shape + ")", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = SortedUnion(small.cbegin(), small.cend(), big.cbegin(), big.cend(), out.begin()) - out.begin(); });
+            PrintResult("SortedUnion (" + shape + ")", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = std::set_difference(small.cbegin(), small.cend(), big.cbegin(), big.cend(), out.begin()) - out.begin(); });
+            PrintResult("std::set_difference (" + shape + ")", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = SortedDifference(small.cbegin(), small.cend(), big.cbegin(), big.cend(), out.begin()) - out.begin(); });
+            PrintResult("SortedDifference (" + shape + ")", n, seconds);
+
+            // Payloads are the positions in each range
+            std::vector<std::pair<int, int>> left(small.size());
+            std::vector<std::pair<int, int>> right(big.size());
+            for (size_t i = 0; i < small.size(); i++)
+            {
+                left[i] = {small[i], static_cast<int>(i)};
+            }
+            for (size_t i = 0; i < big.size(); i++)
+            {
+                right[i] = {big[i], static_cast<int>(i)};
+            }
+            auto key{[](const std::pair<int, int> &p)
+                     { return p.first; }};
+            std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> joined(small.size());
+            seconds = SecondsToRun([&]
+                                   {
+                auto itr{joined.begin()};
+                for (const auto &l : left)
+                {
+                    auto [first, last]{std::equal_range(right.cbegin(), right.cend(), std::pair{l.first, 0}, [](const auto &a, const auto &b)
+                                                        { return a.first < b.first; })};
+                    for (; first != last; ++first)
+                    {
+                        *itr++ = {l, *first};
+                    }
+                }
+                bench_sink = itr - joined.begin(); });
+            PrintResult("std::equal_range per key (" + shape + ")", n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = MergeJoin(left.cbegin(), left.cend(), right.cbegin(), right.cend(), joined.begin(), key, key) - joined.begin(); });
+            PrintResult("MergeJoin (" + shape + ")", n, seconds);
+
+            for (unsigned threads : ThreadCounts())
+            {
+                std::string suffix{" (" + shape + ", " + std::to_string(threads) + " threads)"};
+                seconds = SecondsToRun([&]
+                                       { bench_sink = ParallelSortedIntersection(small.cbegin(), small.cend(), big.cbegin(), big.cend(), out.begin(), threads) - out.begin(); });
+                PrintResult("ParallelSortedIntersection" + suffix, n, seconds);
+                seconds = SecondsToRun([&]
+                                       { bench_sink = ParallelSortedUnion(small.cbegin(), small.cend(), big.cbegin(), big.cend(), out.begin(), threads) - out.begin(); });
+                PrintResult("ParallelSortedUnion" + suffix, n, seconds);
+                seconds = SecondsToRun([&]
+                                       { bench_sink = ParallelMergeJoin(left.cbegin(), left.cend(), right.cbegin(), right.cend(), joined.begin(), threads, key, key) - joined.begin(); });
+                PrintResult("ParallelMergeJoin" + suffix, n, seconds);
+            }
+        }
+        std::cout << std::endl;
+    }
+}
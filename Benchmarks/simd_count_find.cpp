@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/simd.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+std::count, std::count_if (is_even) and std::find (for a value that isn't there, so
+the whole range is scanned) versus the SIMD kernels at every level this CPU supports.
+*/
+void BenchSimdCountFind(size_t max_size)
+{
+    auto is_even{[](int e)
+                 { return e % 2 == 0; }};
+
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> input{RandomInts(n, 0, 1000)};
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::count(input.cbegin(), input.cend(), 0); });
+        PrintResult("std::count", n, seconds);
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::count_if(input.cbegin(), input.cend(), is_even); });
+        PrintResult("std::count_if", n, seconds);
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::find(input.cbegin(), input.cend(), -1) - input.cbegin(); });
+        PrintResult("std::find", n, seconds);
+
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512})
+        {
+            if (level > ActiveSimdLevel())
+            {
+                break;
+            }
+            std::string suffix{" (" + SimdLevelName(level) + ")"};
+            seconds = SecondsToRun([&]
+                                   { bench_sink = SimdCount(input.data(), n, 0, level); });
+            PrintResult("SimdCount" + suffix, n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = SimdCountMasked(input.data(), n, 1, 0, level); });
+            PrintResult("SimdCountMasked" + suffix, n, seconds);
+            seconds = SecondsToRun([&]
+                                   { bench_sink = SimdFind(input.data(), n, -1, level); });
+            PrintResult("SimdFind" + suffix, n, seconds);
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Algorithms/simd.h"
+#include "../Algorithms/sorting_network.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+Sorting max_size / N separate arrays of N ints (and floats) one after another, for N from
+2 to 32: std::sort on each, SortN on each, and SimdSortNBatch at every SIMD level the CPU
+has. Rates are elements per second, so the sizes can be compared with each other.
+*/
+template <size_t N, typename T>
+void BenchSortNetworkSize(size_t max_size)
+{
+    size_t count{std::max<size_t>(1, max_size / N)};
+    size_t n{count * N};
+    std::vector<int> random{RandomInts(n)};
+    std::vector<T> input(random.cbegin(), random.cend());
+    std::vector<T> vec(n);
+    std::string suffix{std::is_same_v<T, float> ? " (float)" : " (int)"};
+    std::string size{"<" + std::to_string(N) + ">"};
+    double seconds;
+
+    vec = input;
+    seconds = SecondsToRun([&]
+                           {
+        for (size_t a = 0; a < count; a++)
+        {
+            std::sort(vec.begin() + a * N, vec.begin() + (a + 1) * N);
+        } });
+    PrintResult("std::sort " + std::to_string(N) + " at a time" + suffix, n, seconds);
+    vec = input;
+    seconds = SecondsToRun([&]
+                           {
+        for (size_t a = 0; a < count; a++)
+        {
+            SortN<N>(vec.begin() + a * N);
+        } });
+    PrintResult("SortN" + size + suffix, n, seconds);
+    for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512})
+    {
+        if (level > ActiveSimdLevel())
+        {
+            break;
+        }
+        vec = input;
+        seconds = SecondsToRun([&]
+                               { SimdSortNBatch<N>(vec.data(), count, level); });
+        PrintResult("SimdSortNBatch" + size + " (" + SimdLevelName(level) + ", " + suffix.substr(2), n, seconds);
+    }
+    bench_sink = static_cast<size_t>(vec[n / 2]);
+}
+
+void BenchSortNetwork(size_t max_size)
+{
+    [&]<size_t... Ns>(std::index_sequence<Ns...>)
+    {
+        ((BenchSortNetworkSize<Ns, int>(max_size), BenchSortNetworkSize<Ns, float>(max_size), std::cout << std::endl), ...);
+    }(std::index_sequence<2, 3, 4, 6, 8, 12, 16, 24, 32>());
+}
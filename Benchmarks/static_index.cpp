@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/static_index.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+Random lower_bound queries on sorted vectors of growing size. Results are in queries
+per second, the size of the searched vector is in the name.
+*/
+void BenchStaticIndex(size_t max_size)
+{
+    constexpr size_t NUM_QUERIES{1 << 20};
+    std::vector<int> queries{RandomInts(NUM_QUERIES, 0, 1'000'000'000, 7)};
+    std::vector<size_t> results(NUM_QUERIES);
+
+    for (size_t n : InputSizes(max_size, 1 << 10, 8))
+    {
+        std::vector<int> sorted{RandomInts(n)};
+        std::sort(sorted.begin(), sorted.end());
+        std::string suffix{" n=" + std::to_string(n)};
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i = 0; i < NUM_QUERIES; i++)
+            {
+                results[i] = std::lower_bound(sorted.cbegin(), sorted.cend(), queries[i]) - sorted.cbegin();
+            } });
+        PrintResult("std::lower_bound" + suffix, NUM_QUERIES, seconds);
+
+        StaticSortedIndex<int> index(sorted);
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i = 0; i < NUM_QUERIES; i++)
+            {
+                results[i] = index.LowerBound(queries[i]);
+            } });
+        PrintResult("StaticSortedIndex::LowerBound" + suffix, NUM_QUERIES, seconds);
+        seconds = SecondsToRun([&]
+                               { index.LowerBoundBatch(queries.data(), NUM_QUERIES, results.data()); });
+        PrintResult("StaticSortedIndex::LowerBoundBatch" + suffix, NUM_QUERIES, seconds);
+        bench_sink = results.back();
+        std::cout << std::endl;
+    }
+}
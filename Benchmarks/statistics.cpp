@@ -0,0 +1,39 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/statistics.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+A loop that only counts (what RangeCounter does) versus the full accumulator, first
+with for_each on one thread and then with ParallelStatistics for every thread count.
+The histogram has 64 buckets over the input range.
+*/
+void BenchStatistics(size_t max_size)
+{
+    constexpr int MAX{1'000'000};
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> input{RandomInts(n, 0, MAX)};
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::count_if(input.cbegin(), input.cend(), [](int e)
+                                                            { return e >= 0; }); });
+        PrintResult("std::count_if", n, seconds);
+        seconds = SecondsToRun([&]
+                               { bench_sink = std::for_each(input.cbegin(), input.cend(), StatisticsAccumulator<int>(0, MAX + 1, 64)).Result().count; });
+        PrintResult("std::for_each StatisticsAccumulator", n, seconds);
+
+        for (unsigned threads : ThreadCounts())
+        {
+            std::string suffix{" (" + std::to_string(threads) + " threads)"};
+            seconds = SecondsToRun([&]
+                                   { bench_sink = ParallelStatistics(input.cbegin(), input.cend(), StatisticsAccumulator<int>(0, MAX + 1, 64), threads).count; });
+            PrintResult("ParallelStatistics" + suffix, n, seconds);
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../Algorithms/top_k.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+/*
+Largest 100 elements of random ints: a full std::sort and std::partial_sort versus
+SelectTopK (in place), TopK (read only, one heap) and ParallelTopK for every thread
+count. The in place ones get a fresh copy of the input each time.
+*/
+void BenchTopK(size_t max_size)
+{
+    constexpr size_t K{100};
+    std::greater<int> comp;
+
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> input{RandomInts(n)};
+        std::vector<int> output(input);
+        double seconds;
+
+        seconds = SecondsToRun([&]
+                               {
+            std::sort(output.begin(), output.end(), comp);
+            bench_sink = output[std::min(K, n) - 1]; });
+        PrintResult("std::sort", n, seconds);
+        output = input;
+        seconds = SecondsToRun([&]
+                               {
+            std::partial_sort(output.begin(), output.begin() + std::min(K, n), output.end(), comp);
+            bench_sink = output[std::min(K, n) - 1]; });
+        PrintResult("std::partial_sort", n, seconds);
+        output = input;
+        seconds = SecondsToRun([&]
+                               { bench_sink = *(SelectTopK(output.begin(), output.end(), K, comp) - 1); });
+        PrintResult("SelectTopK", n, seconds);
+        seconds = SecondsToRun([&]
+                               { bench_sink = TopK(input.cbegin(), input.cend(), K, comp).back(); });
+        PrintResult("TopK", n, seconds);
+
+        for (unsigned threads : ThreadCounts())
+        {
+            std::string suffix{" (" + std::to_string(threads) + " threads)"};
+            seconds = SecondsToRun([&]
+                                   { bench_sink = ParallelTopK(input.cbegin(), input.cend(), K, comp, threads).back(); });
+            PrintResult("ParallelTopK" + suffix, n, seconds);
+        }
+        std::cout << std::endl;
+    }
+}
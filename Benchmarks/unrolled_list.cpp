@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Lists/unrolled_list.h"
+#include "bench_util.h"
+#include "benchmarks.h"
+
+// Number of insertions and erasures timed per size, each one has to find its position first
+constexpr size_t UNROLLED_LIST_OPERATIONS{10};
+
+// Sum of every element, a walk over the whole container
+template <typename Container>
+size_t Sum(const Container &container)
+{
+    size_t total{0};
+    for (int value : container)
+    {
+        total += value;
+    }
+    return total;
+}
+
+/*
+std::vector, std::list and UnrolledList of n random ints: walking each (std::list both
+as built, when malloc has mostly handed out its nodes one after another, and after a
+sort has relinked them in an order unrelated to where they are in memory, as a list
+that has been edited a while ends up), then UNROLLED_LIST_OPERATIONS insertions and
+erasures in the middle. Each insertion or erasure finds its position by index first, as
+code that isn't already holding an iterator there has to: vector's begin() + i is free
+but its insert and erase move everything after (and its first insert reallocates, the
+vector being exactly full); std::list's std::next walks i nodes;
+UnrolledList's advance skips whole nodes. All rows are in elements per second of the n
+being walked or edited.
+*/
+void BenchUnrolledList(size_t max_size)
+{
+    for (size_t n : InputSizes(max_size))
+    {
+        std::vector<int> values{RandomInts(n)};
+        std::vector<size_t> picks;
+        for (size_t i = 0; i < UNROLLED_LIST_OPERATIONS; i++)
+        {
+            picks.push_back(n / 4 + i * n / (2 * UNROLLED_LIST_OPERATIONS));
+        }
+        std::string suffix{" (" + std::to_string(UNROLLED_LIST_OPERATIONS) + " elements)"};
+        double seconds;
+
+        auto list{std::make_unique<std::list<int>>(values.cbegin(), values.cend())};
+        seconds = SecondsToRun([&]
+                               { bench_sink = Sum(*list); });
+        PrintResult("std::list walk (as built)", n, seconds);
+        list->sort();
+        seconds = SecondsToRun([&]
+                               { bench_sink = Sum(*list); });
+        PrintResult("std::list walk (after sort)", n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i : picks)
+            {
+                list->insert(std::next(list->begin(), i), 42);
+            } });
+        PrintResult("std::list insert in middle" + suffix, n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i : picks)
+            {
+                list->erase(std::next(list->begin(), i));
+            } });
+        PrintResult("std::list erase in middle" + suffix, n, seconds);
+        list.reset();
+
+        // Same sorted contents for the others
+        std::sort(values.begin(), values.end());
+        seconds = SecondsToRun([&]
+                               { bench_sink = Sum(values); });
+        PrintResult("std::vector walk", n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i : picks)
+            {
+                values.insert(values.begin() + i, 42);
+            } });
+        PrintResult("std::vector insert in middle" + suffix, n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i : picks)
+            {
+                values.erase(values.begin() + i);
+            } });
+        PrintResult("std::vector erase in middle" + suffix, n, seconds);
+
+        UnrolledList<int> unrolled(values.cbegin(), values.cend());
+        seconds = SecondsToRun([&]
+                               { bench_sink = Sum(unrolled); });
+        PrintResult("UnrolledList walk", n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i : picks)
+            {
+                unrolled.insert(unrolled.begin().advance(i), 42);
+            } });
+        PrintResult("UnrolledList insert in middle" + suffix, n, seconds);
+        seconds = SecondsToRun([&]
+                               {
+            for (size_t i : picks)
+            {
+                unrolled.erase(unrolled.begin().advance(i));
+            } });
+        PrintResult("UnrolledList erase in middle" + suffix, n, seconds);
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,253 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/*
+Shared version of the DisplayContainer and DisplayMap templates that used to be
+copied into Algorithms, Lists, Sets and Maps.
+
+The old versions sent every element through std::cout << and ended with std::endl.
+std::endl doesn't just write a newline, it also flushes the stream, see:
+https://en.cppreference.com/w/cpp/io/manip/endl
+and every << on cout is a separate call into the stream machinery (locale, width
+checks, sync with C stdio). For a container with millions of elements that adds
+up to seconds.
+
+Instead, elements are formatted straight into a reusable char buffer: integers with
+std::to_chars (no locale, no allocation, see: https://en.cppreference.com/w/cpp/utility/to_chars)
+and strings by copying their bytes. The buffer is handed to the stream in one big
+write() when it fills up, and the stream is only flushed when Flush() is called.
+
+The text is the same as << on the stream would give, including its formatting state:
+to_chars and plain copies are only used while the stream is in its default decimal,
+no width state. Floating point numbers always go through << (to_chars would print the
+shortest round trip form, 0.30000000000000004 where << prints 0.3 at the default
+precision), and so do signed and unsigned char (which << prints as characters), bool
+under boolalpha and anything once a width, base or showpos is set.
+*/
+class OutputBuffer
+{
+private:
+    std::ostream &out;
+    std::vector<char> buffer;
+    size_t used;
+
+    // Make sure at least n more chars fit, writing out what's buffered if they don't
+    void Reserve(size_t n)
+    {
+        if (buffer.size() - used < n)
+        {
+            WriteOut();
+        }
+    }
+
+    // Whether plain chars and to_chars give what << would: no width, decimal, no showpos
+    bool PlainFormat() const
+    {
+        std::ios_base::fmtflags base{out.flags() & std::ios_base::basefield};
+        return out.width() == 0 && (base == std::ios_base::dec || base == 0) && !(out.flags() & std::ios_base::showpos);
+    }
+
+    /*
+    Formats value with << in a stringstream set up like the stream (precision, flags,
+    width, fill and locale), which allocates. Like << on the stream, it uses up the width.
+    */
+    template <typename T>
+    void WriteFormatted(const T &value)
+    {
+        std::ostringstream stream;
+        stream.copyfmt(out);
+        stream << value;
+        out.width(0);
+        Write(std::string_view(stream.str()));
+    }
+
+public:
+    // More than the chars to_chars can produce for any integer type (a sign and 39 digits for 128 bits)
+    static constexpr size_t MAX_NUMBER_CHARS{64};
+
+    OutputBuffer(std::ostream &o = std::cout, size_t capacity = 1 << 16) : out(o), buffer(std::max(capacity, MAX_NUMBER_CHARS)), used(0) {}
+
+    // Copying would write the same buffered text twice
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+    // Whatever is still buffered is written (but not flushed) when the buffer goes away
+    ~OutputBuffer()
+    {
+        WriteOut();
+    }
+
+    // Hand the buffered chars to the stream in a single write, without flushing the stream
+    void WriteOut()
+    {
+        if (used > 0)
+        {
+            out.write(buffer.data(), static_cast<std::streamsize>(used));
+            used = 0;
+        }
+    }
+
+    // WriteOut and flush the stream (what std::endl did on every call before)
+    void Flush()
+    {
+        WriteOut();
+        out.flush();
+    }
+
+    void Write(char c)
+    {
+        if (out.width() != 0)
+        {
+            WriteFormatted(c);
+            return;
+        }
+        Reserve(1);
+        buffer[used++] = c;
+    }
+
+    void Write(std::string_view text)
+    {
+        if (out.width() != 0)
+        {
+            WriteFormatted(text);
+            return;
+        }
+        // Text bigger than the whole buffer skips it rather than being split up
+        if (text.size() > buffer.size())
+        {
+            WriteOut();
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            return;
+        }
+        Reserve(text.size());
+        text.copy(buffer.data() + used, text.size());
+        used += text.size();
+    }
+
+    // Also catches types that convert to const char * (e.g. Record in Lists)
+    void Write(const char *text)
+    {
+        Write(std::string_view(text));
+    }
+
+    void Write(bool b)
+    {
+        if (!PlainFormat() || (out.flags() & std::ios_base::boolalpha))
+        {
+            WriteFormatted(b);
+            return;
+        }
+        Write(std::string_view(b ? "1" : "0"));
+    }
+
+    // Integers are formatted directly into the buffer, the rest of the arithmetic types like << does them
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    void Write(T value)
+    {
+        if constexpr (std::is_floating_point_v<T> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>)
+        {
+            WriteFormatted(value);
+        }
+        else
+        {
+            // wchar_t, char8_t, char16_t and char32_t have no << on a char stream, they always print as numbers
+            if constexpr (requires(std::ostream &o) { o << value; })
+            {
+                if (!PlainFormat())
+                {
+                    WriteFormatted(value);
+                    return;
+                }
+            }
+            Reserve(MAX_NUMBER_CHARS);
+            auto result{std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value)};
+            used = static_cast<size_t>(result.ptr - buffer.data());
+        }
+    }
+
+    /*
+    Anything else that supports << (the only thing the old DisplayContainer needed) goes
+    through WriteFormatted, which allocates, but keeps DisplayContainer working for
+    every element type it used to.
+    */
+    template <typename T>
+        requires(!std::is_arithmetic_v<T> && !std::is_convertible_v<const T &, std::string_view> && !std::is_convertible_v<const T &, const char *>)
+    void Write(const T &value)
+    {
+        WriteFormatted(value);
+    }
+};
+
+/*
+One buffer per thread, kept around between calls so printing doesn't allocate after
+the first call.
+*/
+inline OutputBuffer &StandardOutputBuffer()
+{
+    thread_local OutputBuffer buffer(std::cout);
+    return buffer;
+}
+
+// Same output as before, works with any container with cbegin(), cend() and size()
+template <typename T>
+void DisplayContainer(const T &container, OutputBuffer &buffer)
+{
+    buffer.Write(std::string_view("[ "));
+    for (auto itr = container.cbegin(); itr != container.cend(); itr++)
+    {
+        buffer.Write(*itr);
+        buffer.Write(' ');
+    }
+    buffer.Write(std::string_view("] size = "));
+    buffer.Write(container.size());
+    buffer.Write('\n');
+}
+
+template <typename T>
+void DisplayMap(const T &container, OutputBuffer &buffer)
+{
+    buffer.Write(std::string_view("[ "));
+    for (auto itr = container.cbegin(); itr != container.cend(); itr++)
+    {
+        buffer.Write('(');
+        buffer.Write(itr->first);
+        buffer.Write(std::string_view(", "));
+        buffer.Write(itr->second);
+        buffer.Write(std::string_view(") "));
+    }
+    buffer.Write(std::string_view("] size = "));
+    buffer.Write(container.size());
+    buffer.Write('\n');
+}
+
+/*
+The versions used by the demos print to std::cout. The text is handed to cout at the
+end of each call (so it comes out in the right order with other cout << calls) but
+cout isn't flushed. To print many containers with one write, pass an OutputBuffer.
+*/
+template <typename T>
+void DisplayContainer(const T &container)
+{
+    DisplayContainer(container, StandardOutputBuffer());
+    StandardOutputBuffer().WriteOut();
+}
+
+template <typename T>
+void DisplayMap(const T &container)
+{
+    DisplayMap(container, StandardOutputBuffer());
+    StandardOutputBuffer().WriteOut();
+}
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef INDEXED_RECORDS_H
+#define INDEXED_RECORDS_H
+
+#include <cstddef>
+#include <list>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "record.h"
+
+/*
+A collection of Records that can find or remove one by name or by phone number in O(1).
+
+With a plain std::list<Record> removing by name is list19.remove(Record("A B", "")): it
+builds a dummy Record (three strings, and an allocation for display) just to have
+something for operator== to compare against, then compares it with every element, O(n).
+
+Here the Records live in a std::list, which never moves them, and two hash tables map
+each name and each phone number to its Record's position in the list. The tables' keys
+are string_views into the Records' own strings rather than copies: a string's characters
+only move when the string is changed or moved, and a Record in a list node is neither.
+Since the keys are string_views, looking up with a string literal, std::string or
+string_view builds nothing (see: https://en.cppreference.com/w/cpp/container/unordered_map/find
+for the C++20 heterogeneous lookup that would otherwise be needed to find a std::string
+key without making one).
+
+Names and phone numbers are both unique: adding a Record whose name or phone number is
+already there does nothing. Iteration goes in the order Records were added.
+*/
+class IndexedRecords
+{
+private:
+    using Position = std::list<Record>::const_iterator;
+
+    std::list<Record> records;
+    std::unordered_map<std::string_view, Position> by_name;
+    std::unordered_map<std::string_view, Position> by_phone_number;
+
+    template <typename Index>
+    static const Record *Find(const Index &index, std::string_view key)
+    {
+        auto itr{index.find(key)};
+        return itr == index.end() ? nullptr : &*itr->second;
+    }
+
+    // Drops the Record at position from both indexes, then from the list (the keys point into it)
+    Position Erase(Position position)
+    {
+        by_name.erase(position->Name());
+        by_phone_number.erase(position->PhoneNumber());
+        return records.erase(position);
+    }
+
+public:
+    using const_iterator = Position;
+
+    IndexedRecords() = default;
+
+    // A copy's indexes would still point into the original's Records. Moving keeps the list nodes, so that's fine
+    IndexedRecords(const IndexedRecords &) = delete;
+    IndexedRecords &operator=(const IndexedRecords &) = delete;
+    IndexedRecords(IndexedRecords &&) = default;
+    IndexedRecords &operator=(IndexedRecords &&) = default;
+
+    // Sizes the indexes for n Records, so they don't rehash while growing to that
+    void reserve(size_t n)
+    {
+        by_name.reserve(n);
+        by_phone_number.reserve(n);
+    }
+
+    /*
+    Adds Record(name, phone_number) at the end. Returns its position and true, or if the
+    name or phone number is taken, the position of the Record that has it and false.
+    */
+    std::pair<const_iterator, bool> Insert(std::string_view name, std::string_view phone_number)
+    {
+        if (auto itr{by_name.find(name)}; itr != by_name.end())
+        {
+            return {itr->second, false};
+        }
+        if (auto itr{by_phone_number.find(phone_number)}; itr != by_phone_number.end())
+        {
+            return {itr->second, false};
+        }
+        Position position{records.emplace(records.cend(), name, phone_number)};
+        by_name.emplace(position->Name(), position);
+        by_phone_number.emplace(position->PhoneNumber(), position);
+        return {position, true};
+    }
+
+    // The Record with this name, or nullptr
+    const Record *FindByName(std::string_view name) const
+    {
+        return Find(by_name, name);
+    }
+
+    const Record *FindByPhoneNumber(std::string_view phone_number) const
+    {
+        return Find(by_phone_number, phone_number);
+    }
+
+    // Removes the Record with this name, returns whether there was one
+    bool EraseByName(std::string_view name)
+    {
+        auto itr{by_name.find(name)};
+        if (itr == by_name.end())
+        {
+            return false;
+        }
+        Erase(itr->second);
+        return true;
+    }
+
+    bool EraseByPhoneNumber(std::string_view phone_number)
+    {
+        auto itr{by_phone_number.find(phone_number)};
+        if (itr == by_phone_number.end())
+        {
+            return false;
+        }
+        Erase(itr->second);
+        return true;
+    }
+
+    // Removes the Record at position, returns the position after it (like list::erase)
+    const_iterator erase(const_iterator position)
+    {
+        return Erase(position);
+    }
+
+    void clear()
+    {
+        by_name.clear();
+        by_phone_number.clear();
+        records.clear();
+    }
+
+    size_t size() const
+    {
+        return records.size();
+    }
+
+    bool empty() const
+    {
+        return records.empty();
+    }
+
+    const_iterator cbegin() const
+    {
+        return records.cbegin();
+    }
+
+    const_iterator cend() const
+    {
+        return records.cend();
+    }
+
+    const_iterator begin() const
+    {
+        return records.cbegin();
+    }
+
+    const_iterator end() const
+    {
+        return records.cend();
+    }
+};
+
+#endif
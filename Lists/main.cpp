@@ -5,76 +5,20 @@
 #include <string>
 #include <string_view>
 
-template <typename T>
-void DisplayContainer(const T &container)
-{
-    std::cout << "[ ";
-    for (auto itr = container.cbegin(); itr != container.cend(); itr++)
-    {
-        std::cout << *itr << " ";
-    }
-    std::cout << "] size = " << container.size() << std::endl;
-}
+// DisplayContainer and DisplayMap are shared with other folders, see Common/display.h
+#include "../Common/display.h"
+#include "record.h"
+#include "record_store.h"
+#include "prefix_sort.h"
+#include "indexed_records.h"
+#include "pool_list.h"
+#include "unrolled_list.h"
 
 bool SortPredicateDescending(const int &lhs, const int &rhs)
 {
     return lhs > rhs;
 }
 
-class Record
-{
-private:
-    std::string name;
-    std::string phone_number;
-    // Why do we store this string? See discussion above constructor
-    std::string display;
-
-public:
-    // Make this a friend so it can access private member phone_number
-    friend bool SortOnPhoneNumber(const Record &lhs, const Record &rhs);
-
-    /*
-    Q1: Why take const string& not string_view? Because we cannot easily create display
-    member with string_views as string_view cannot be concatenated with a string or
-    const char (see: https://stackoverflow.com/a/47735624). Thus, we would have to create
-    a string copy anyway if we were say taking a literal (as we do when we construct
-    Records in main code) through a string_view because that string_view would have to
-    be turned into a string to do concatenation. const string& will take the temporarily
-    created string to accomodate the literal as reference.
-
-    Q2: Why do we store display as a member? Because, if we were to create it locally in
-    our const char* operator, then when we call c_str on a local variable, it will
-    become invalidated upon function return as all it does is provide a pointer to
-    the contents of a string (see: https://stackoverflow.com/a/27627466)
-    */
-    Record(std::string_view n, std::string_view pn) : name(n), phone_number(pn) {
-        display = "[" + name + " " + phone_number + "]";
-    }
-
-    // Defines how list::remove (and Record equality in general) will work
-    bool operator==(const Record &other) const
-    {
-        return this->name == other.name;
-    }
-
-    // Defines how list::sort works without a passed predicate function
-    bool operator<(const Record &other) const
-    {
-        return this->name < other.name;
-    }
-
-    // See discussion above
-    operator const char *() const
-    {
-        return display.c_str();
-    }
-};
-
-bool SortOnPhoneNumber(const Record &lhs, const Record &rhs)
-{
-    return lhs.phone_number < rhs.phone_number;
-}
-
 int main()
 {
     // Creating lists
@@ -234,6 +178,84 @@ int main()
     list19.remove(Record("A B", ""));
     DisplayContainer(list19);
 
+    /*
+    list::sort follows node pointers and compares whole strings at every step. For long
+    lists, PrefixSort (see prefix_sort.h) sorts the first 8 bytes of each key in an array
+    and then relinks the nodes in order, giving the same (stable) result as list::sort.
+    */
+    PrefixSort(list19, [](const Record &r)
+               { return r.Name(); });
+    DisplayContainer(list19);
+
+    /*
+    remove has to build a dummy Record and compare it with every element. IndexedRecords
+    (see indexed_records.h) keeps hash indexes on name and phone number, so finding or
+    removing a Record by either takes O(1) and only needs the key.
+    */
+    IndexedRecords records1;
+    records1.Insert("B C", "123");
+    records1.Insert("A B", "789");
+    records1.Insert("A C", "456");
+    records1.EraseByName("A B");
+    DisplayContainer(records1);
+    std::cout << records1.FindByPhoneNumber("456")->Name() << std::endl;
+
+    /*
+    Every std::list node is a separate allocation. PoolList (see pool_list.h) does the
+    same things with nodes taken from slabs, and can unlink an element given just a
+    reference to it (std::list needs an iterator for that).
+    */
+    PoolList<Record> list22;
+    list22.push_back(Record("B C", "123"));
+    list22.push_back(Record("A B", "789"));
+    list22.push_back(Record("A C", "456"));
+    list22.sort(SortOnPhoneNumber);
+    Record &middle{*++list22.begin()};
+    list22.unlink(middle);
+    DisplayContainer(list22);
+
+    /*
+    Tens of millions of Records get expensive, each is three strings that can each need
+    their own allocation. RecordStore (see record_store.h) packs the names and numbers
+    into shared blocks and only builds the display form when asked, into a buffer we
+    pass in. Bytes per record for 10000 records stored both ways:
+    */
+    std::list<Record> list21;
+    RecordStore store1;
+    for (int i = 0; i < 10000; i++)
+    {
+        std::string name{"Firstname Lastname" + std::to_string(i)};
+        std::string phone_number{"555-" + std::to_string(1000000 + i)};
+        list21.push_back(Record(name, phone_number));
+        store1.Add(name, phone_number);
+    }
+    char display_buffer[64];
+    std::cout << store1.Display(42, display_buffer, sizeof(display_buffer)) << std::endl;
+    size_t record_bytes{0};
+    for (const Record &record : list21)
+    {
+        record_bytes += record.MemoryUsage();
+    }
+    std::cout << record_bytes / list21.size() << " " << store1.BytesPerRecord() << std::endl;
+
+    /*
+    UnrolledList (see unrolled_list.h) keeps a small array of elements in each node, so
+    walking it is mostly walking arrays, and its iterators can advance(n) a node at a time
+    where list6 above couldn't do + n. Inserting and erasing in the middle stay O(1).
+    */
+    UnrolledList<int> list23(vector1.cbegin(), vector1.cend());
+    auto third{list23.begin().advance(2)};
+    third = list23.insert(third, 42);
+    list23.erase(third.advance(1));
+    list23.push_front(0);
+    DisplayContainer(list23);
+
+    // Like list::insert, inserting a copy of one of the list's own elements works, even when the node it goes in is full and has to split
+    UnrolledList<std::string, 4> list24{"first string in the list", "second string in the list",
+                                        "third string in the list", "fourth string in the list"};
+    list24.insert(list24.begin().advance(1), *list24.begin().advance(3));
+    DisplayContainer(list24);
+
     // C++ also supports a singly linked list in forward_list: https://cplusplus.com/reference/forward_list/forward_list/
 
     return 0;
@@ -0,0 +1,592 @@
+#ifndef POOL_LIST_H
+#define POOL_LIST_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+A doubly linked list like std::list whose nodes come from a pool instead of one malloc
+each.
+
+std::list allocates every node separately, so building a list of a million elements is
+a million calls to malloc (and destroying it a million calls to free), and the nodes end
+up wherever malloc found room, so walking the list jumps all over memory. PoolList gets
+its nodes a slab at a time (16 nodes, then twice as many each time up to
+POOL_LIST_MAX_SLAB_BYTES) and hands them out in order, so nodes next to each other in the list
+usually sit next to each other in memory. Erased nodes go on a free list to be reused by
+the next insert, and the slabs are only given back when the list is destroyed, all at
+once.
+
+The links and the element share one node, so from a reference to an element its node
+(and so its place in the list) is found by subtracting a fixed offset, like intrusive
+lists do (e.g. the Linux kernel's container_of). That makes unlink(element) and
+iterator_to(element) O(1) with no search, where std::list would need an iterator kept
+from when the element was inserted. For that offset to be well defined the element type
+must be standard layout (no virtual functions, no references, every data member with the
+same access), which Record is.
+
+The API is the part of std::list that Lists/main.cpp uses. Differences: there's no
+splice, since nodes belong to their list's pool and couldn't be freed by another list,
+and a moved from PoolList is empty but keeps nothing of its slabs.
+*/
+
+/*
+Largest slab in bytes. glibc's malloc hands out blocks of 128 KB and up with a fresh
+mmap of their own, which has to be paged in one page fault at a time and goes back to
+the OS when freed, so slabs stay below that and are recycled by malloc like small blocks.
+*/
+constexpr size_t POOL_LIST_MAX_SLAB_BYTES{1 << 16};
+
+// The links at the start of every node, and the whole of the list's end (sentinel) node
+struct ListLinks
+{
+    ListLinks *prev;
+    ListLinks *next;
+};
+
+template <typename T>
+class PoolList
+{
+private:
+    struct Node
+    {
+        ListLinks links;
+        T value;
+    };
+    static_assert(std::is_standard_layout_v<Node>, "PoolList elements must be standard layout, so a node can be found from its element");
+
+    // head.next is the first node and head.prev the last, both &head when empty
+    ListLinks head;
+    size_t count;
+    std::vector<std::pair<Node *, size_t>> slabs;
+    // Nodes of the newest slab that have never been handed out
+    Node *unused_begin;
+    Node *unused_end;
+    // Erased nodes, chained through links.next
+    ListLinks *free_nodes;
+    size_t next_slab_size;
+
+    // links is the first member of a standard layout Node, so they share an address
+    static T &ValueOf(ListLinks *links)
+    {
+        return reinterpret_cast<Node *>(links)->value;
+    }
+
+    static ListLinks *LinksOf(const T &value)
+    {
+        return reinterpret_cast<ListLinks *>(reinterpret_cast<char *>(const_cast<T *>(std::addressof(value))) - offsetof(Node, value));
+    }
+
+    // Reuses an erased node if there is one, else takes the next unused node of the newest slab
+    ListLinks *AllocateNode()
+    {
+        if (free_nodes != nullptr)
+        {
+            ListLinks *links{free_nodes};
+            free_nodes = links->next;
+            return links;
+        }
+        if (unused_begin == unused_end)
+        {
+            unused_begin = std::allocator<Node>().allocate(next_slab_size);
+            unused_end = unused_begin + next_slab_size;
+            slabs.emplace_back(unused_begin, next_slab_size);
+            next_slab_size = std::max<size_t>(next_slab_size, std::min(next_slab_size * 2, POOL_LIST_MAX_SLAB_BYTES / sizeof(Node)));
+        }
+        return reinterpret_cast<ListLinks *>(unused_begin++);
+    }
+
+    void FreeNode(ListLinks *links)
+    {
+        links->next = free_nodes;
+        free_nodes = links;
+    }
+
+    template <typename... Args>
+    ListLinks *Emplace(ListLinks *position, Args &&...args)
+    {
+        ListLinks *links{AllocateNode()};
+        try
+        {
+            std::construct_at(std::addressof(ValueOf(links)), std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            FreeNode(links);
+            throw;
+        }
+        links->prev = position->prev;
+        links->next = position;
+        position->prev->next = links;
+        position->prev = links;
+        count++;
+        return links;
+    }
+
+    // Destroys the element, returns its node to the free list and the next node
+    ListLinks *Unlink(ListLinks *links)
+    {
+        ListLinks *next{links->next};
+        links->prev->next = next;
+        next->prev = links->prev;
+        std::destroy_at(std::addressof(ValueOf(links)));
+        FreeNode(links);
+        count--;
+        return next;
+    }
+
+    // Merges two sorted chains (ended by nullptr, prev not kept up), taking from first on ties
+    template <typename Compare>
+    static ListLinks *Merge(ListLinks *first, ListLinks *second, Compare &comp)
+    {
+        ListLinks merged{};
+        ListLinks *tail{&merged};
+        while (first != nullptr && second != nullptr)
+        {
+            if (comp(ValueOf(second), ValueOf(first)))
+            {
+                tail->next = second;
+                second = second->next;
+            }
+            else
+            {
+                tail->next = first;
+                first = first->next;
+            }
+            tail = tail->next;
+        }
+        tail->next = first != nullptr ? first : second;
+        return merged.next;
+    }
+
+    void Reset()
+    {
+        head.prev = &head;
+        head.next = &head;
+        count = 0;
+        unused_begin = nullptr;
+        unused_end = nullptr;
+        free_nodes = nullptr;
+        next_slab_size = 16;
+    }
+
+    template <bool Const>
+    class Iterator
+    {
+    private:
+        friend class PoolList;
+        template <bool>
+        friend class Iterator;
+        ListLinks *links;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T *, T *>;
+        using reference = std::conditional_t<Const, const T &, T &>;
+
+        Iterator() : links(nullptr) {}
+        explicit Iterator(ListLinks *l) : links(l) {}
+
+        // iterator converts to const_iterator, like std::list's
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst> &other) : links(other.links) {}
+
+        reference operator*() const
+        {
+            return ValueOf(links);
+        }
+
+        pointer operator->() const
+        {
+            return std::addressof(ValueOf(links));
+        }
+
+        Iterator &operator++()
+        {
+            links = links->next;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old{*this};
+            links = links->next;
+            return old;
+        }
+
+        Iterator &operator--()
+        {
+            links = links->prev;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            Iterator old{*this};
+            links = links->prev;
+            return old;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return links == other.links;
+        }
+    };
+
+public:
+    using value_type = T;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    PoolList()
+    {
+        Reset();
+    }
+
+    PoolList(size_t n, const T &value) : PoolList()
+    {
+        insert(cend(), n, value);
+    }
+
+    template <typename InputIt>
+    PoolList(InputIt first, InputIt last) : PoolList()
+    {
+        insert(cend(), first, last);
+    }
+
+    PoolList(std::initializer_list<T> values) : PoolList(values.begin(), values.end()) {}
+
+    PoolList(const PoolList &other) : PoolList(other.cbegin(), other.cend()) {}
+
+    PoolList(PoolList &&other) noexcept : PoolList()
+    {
+        swap(other);
+    }
+
+    // Copy and swap, other is a copy or was moved from
+    PoolList &operator=(PoolList other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    // Elements are destroyed in place, without unlinking them one by one, then the slabs are freed
+    ~PoolList()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (ListLinks *links = head.next; links != &head; links = links->next)
+            {
+                std::destroy_at(std::addressof(ValueOf(links)));
+            }
+        }
+        for (auto [slab, size] : slabs)
+        {
+            std::allocator<Node>().deallocate(slab, size);
+        }
+    }
+
+    // The first and last nodes point at head, so they have to be pointed at the other list's head
+    void swap(PoolList &other) noexcept
+    {
+        std::swap(head, other.head);
+        std::swap(count, other.count);
+        std::swap(slabs, other.slabs);
+        std::swap(unused_begin, other.unused_begin);
+        std::swap(unused_end, other.unused_end);
+        std::swap(free_nodes, other.free_nodes);
+        std::swap(next_slab_size, other.next_slab_size);
+        for (PoolList *list : {this, &other})
+        {
+            if (list->count == 0)
+            {
+                list->head.prev = &list->head;
+                list->head.next = &list->head;
+            }
+            else
+            {
+                list->head.next->prev = &list->head;
+                list->head.prev->next = &list->head;
+            }
+        }
+    }
+
+    iterator begin()
+    {
+        return iterator(head.next);
+    }
+
+    iterator end()
+    {
+        return iterator(&head);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(head.next);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(const_cast<ListLinks *>(&head));
+    }
+
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    // Slabs allocated so far, every node this list has ever used came from one of these
+    size_t slab_count() const
+    {
+        return slabs.size();
+    }
+
+    T &front()
+    {
+        return ValueOf(head.next);
+    }
+
+    T &back()
+    {
+        return ValueOf(head.prev);
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator position, Args &&...args)
+    {
+        return iterator(Emplace(position.links, std::forward<Args>(args)...));
+    }
+
+    iterator insert(const_iterator position, const T &value)
+    {
+        return emplace(position, value);
+    }
+
+    iterator insert(const_iterator position, T &&value)
+    {
+        return emplace(position, std::move(value));
+    }
+
+    // Inserts n copies of value before position, returns the first one (or position if n is 0)
+    iterator insert(const_iterator position, size_t n, const T &value)
+    {
+        iterator first(position.links);
+        for (size_t i = 0; i < n; i++)
+        {
+            iterator inserted{emplace(position, value)};
+            if (i == 0)
+            {
+                first = inserted;
+            }
+        }
+        return first;
+    }
+
+    template <typename InputIt>
+    iterator insert(const_iterator position, InputIt first, InputIt last)
+    {
+        iterator inserted_first(position.links);
+        for (bool is_first = true; first != last; ++first, is_first = false)
+        {
+            iterator inserted{emplace(position, *first)};
+            if (is_first)
+            {
+                inserted_first = inserted;
+            }
+        }
+        return inserted_first;
+    }
+
+    void push_front(const T &value)
+    {
+        Emplace(head.next, value);
+    }
+
+    void push_front(T &&value)
+    {
+        Emplace(head.next, std::move(value));
+    }
+
+    void push_back(const T &value)
+    {
+        Emplace(&head, value);
+    }
+
+    void push_back(T &&value)
+    {
+        Emplace(&head, std::move(value));
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        return ValueOf(Emplace(&head, std::forward<Args>(args)...));
+    }
+
+    void pop_front()
+    {
+        Unlink(head.next);
+    }
+
+    void pop_back()
+    {
+        Unlink(head.prev);
+    }
+
+    iterator erase(const_iterator position)
+    {
+        return iterator(Unlink(position.links));
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        ListLinks *links{first.links};
+        while (links != last.links)
+        {
+            links = Unlink(links);
+        }
+        return iterator(links);
+    }
+
+    // Position of an element of this list, from a reference to it
+    iterator iterator_to(T &element)
+    {
+        return iterator(LinksOf(element));
+    }
+
+    const_iterator iterator_to(const T &element) const
+    {
+        return const_iterator(LinksOf(element));
+    }
+
+    // Removes an element of this list given a reference to it, in O(1)
+    void unlink(const T &element)
+    {
+        Unlink(LinksOf(element));
+    }
+
+    // The nodes go back on the free list, the slabs stay for the next inserts
+    void clear()
+    {
+        erase(cbegin(), cend());
+    }
+
+    // Swaps prev and next in every node, the head included
+    void reverse()
+    {
+        ListLinks *links{&head};
+        do
+        {
+            std::swap(links->prev, links->next);
+            links = links->prev;
+        } while (links != &head);
+    }
+
+    template <typename Predicate>
+    size_t remove_if(Predicate pred)
+    {
+        size_t removed{0};
+        for (ListLinks *links = head.next; links != &head;)
+        {
+            if (pred(ValueOf(links)))
+            {
+                links = Unlink(links);
+                removed++;
+            }
+            else
+            {
+                links = links->next;
+            }
+        }
+        return removed;
+    }
+
+    size_t remove(const T &value)
+    {
+        return remove_if([&](const T &element)
+                         { return element == value; });
+    }
+
+    /*
+    Stable merge sort on the links, like list::sort: nodes are relinked, never copied or
+    moved, so references and iterators to elements stay valid. Runs of 1, 2, 4... nodes
+    are merged into bins[i] holding 2^i nodes, then the bins are merged together and the
+    prev links are rebuilt in one walk at the end.
+    */
+    template <typename Compare>
+    void sort(Compare comp)
+    {
+        if (count < 2)
+        {
+            return;
+        }
+        head.prev->next = nullptr;
+        ListLinks *chain{head.next};
+        ListLinks *bins[64]{};
+        while (chain != nullptr)
+        {
+            ListLinks *run{chain};
+            chain = chain->next;
+            run->next = nullptr;
+            size_t i{0};
+            for (; bins[i] != nullptr; i++)
+            {
+                // bins[i] holds earlier elements than run, so it goes first to keep ties in order
+                run = Merge(bins[i], run, comp);
+                bins[i] = nullptr;
+            }
+            bins[i] = run;
+        }
+        ListLinks *sorted{nullptr};
+        for (ListLinks *bin : bins)
+        {
+            if (bin != nullptr)
+            {
+                sorted = sorted == nullptr ? bin : Merge(bin, sorted, comp);
+            }
+        }
+
+        ListLinks *prev{&head};
+        for (ListLinks *links = sorted; links != nullptr; links = links->next)
+        {
+            links->prev = prev;
+            prev->next = links;
+            prev = links;
+        }
+        prev->next = &head;
+        head.prev = prev;
+    }
+
+    void sort()
+    {
+        sort(std::less<T>());
+    }
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef PREFIX_SORT_H
+#define PREFIX_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <string_view>
+#include <vector>
+
+#include "../Algorithms/radix_sort.h"
+
+/*
+A faster list::sort for elements sorted by a string key, like a list of Records by name
+(list19.sort() in main.cpp) or phone number (list19.sort(SortOnPhoneNumber)).
+
+list::sort is a merge sort on the nodes themselves: every step follows a next pointer to
+a node that can be anywhere in memory, and every comparison is a full string compare that
+follows the string's own pointer to its characters. Instead, PrefixSort walks the list
+once and copies the first 8 bytes of each key into an array of uint64_t, big-endian
+(first byte in the top bits) and zero padded, so comparing two prefixes as integers
+orders them the same way as comparing the strings. The prefixes are sorted with
+RadixSortByKey (see Algorithms/radix_sort.h) carrying an iterator to each node along, so
+the sort only touches two contiguous arrays. Keys that share their first 8 bytes end up
+next to each other, and only those runs are sorted again with full string compares.
+Finally each node is spliced to the end of the list in sorted order: one pass, no node
+is copied or reallocated, and iterators and references to elements stay valid, as with
+list::sort.
+
+Like list::sort it's stable, equal keys keep their order.
+*/
+
+// First 8 bytes of key, big-endian and padded with zero bytes
+inline uint64_t KeyPrefix(std::string_view key)
+{
+    uint64_t prefix{0};
+    size_t n{std::min<size_t>(key.size(), sizeof(prefix))};
+    for (size_t i = 0; i < n; i++)
+    {
+        prefix |= uint64_t{static_cast<unsigned char>(key[i])} << (8 * (sizeof(prefix) - 1 - i));
+    }
+    return prefix;
+}
+
+/*
+Sorts list by key(element), which must return a std::string_view (or something that
+converts to one) that stays valid during the sort, e.g.
+PrefixSort(records, [](const Record &r) { return r.Name(); }).
+*/
+template <typename T, typename Key>
+void PrefixSort(std::list<T> &list, Key key)
+{
+    using Iterator = typename std::list<T>::iterator;
+    std::vector<uint64_t> prefixes;
+    std::vector<Iterator> nodes;
+    prefixes.reserve(list.size());
+    nodes.reserve(list.size());
+    for (auto itr = list.begin(); itr != list.end(); ++itr)
+    {
+        prefixes.push_back(KeyPrefix(key(*itr)));
+        nodes.push_back(itr);
+    }
+    RadixSortByKey(prefixes.begin(), prefixes.end(), nodes.begin());
+
+    auto full_less{[&](Iterator lhs, Iterator rhs)
+                   { return std::string_view(key(*lhs)) < std::string_view(key(*rhs)); }};
+    for (size_t begin = 0; begin < prefixes.size();)
+    {
+        size_t end{begin + 1};
+        while (end < prefixes.size() && prefixes[end] == prefixes[begin])
+        {
+            end++;
+        }
+        if (end - begin > 1)
+        {
+            std::stable_sort(nodes.begin() + begin, nodes.begin() + end, full_less);
+        }
+        begin = end;
+    }
+
+    for (Iterator node : nodes)
+    {
+        list.splice(list.end(), list, node);
+    }
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// The Record used by the demos in main.cpp, in a header so record_store.h and Benchmarks can use it too
+class Record
+{
+private:
+    std::string name;
+    std::string phone_number;
+    // Why do we store this string? See discussion above constructor
+    std::string display;
+
+public:
+    // Make this a friend so it can access private member phone_number
+    friend bool SortOnPhoneNumber(const Record &lhs, const Record &rhs);
+
+    /*
+    Q1: Why take const string& not string_view? Because we cannot easily create display
+    member with string_views as string_view cannot be concatenated with a string or
+    const char (see: https://stackoverflow.com/a/47735624). Thus, we would have to create
+    a string copy anyway if we were say taking a literal (as we do when we construct
+    Records in main code) through a string_view because that string_view would have to
+    be turned into a string to do concatenation. const string& will take the temporarily
+    created string to accomodate the literal as reference.
+
+    Q2: Why do we store display as a member? Because, if we were to create it locally in
+    our const char* operator, then when we call c_str on a local variable, it will
+    become invalidated upon function return as all it does is provide a pointer to
+    the contents of a string (see: https://stackoverflow.com/a/27627466)
+    */
+    Record(std::string_view n, std::string_view pn) : name(n), phone_number(pn) {
+        display = "[" + name + " " + phone_number + "]";
+    }
+
+    // Read only views, e.g. for pulling sort keys out of a Record (see prefix_sort.h)
+    std::string_view Name() const
+    {
+        return name;
+    }
+
+    std::string_view PhoneNumber() const
+    {
+        return phone_number;
+    }
+
+    // Defines how list::remove (and Record equality in general) will work
+    bool operator==(const Record &other) const
+    {
+        return this->name == other.name;
+    }
+
+    // Defines how list::sort works without a passed predicate function
+    bool operator<(const Record &other) const
+    {
+        return this->name < other.name;
+    }
+
+    // See discussion above
+    operator const char *() const
+    {
+        return display.c_str();
+    }
+
+    /*
+    Bytes this Record takes up: the object itself plus the heap buffer of each string
+    that's too long for the small string optimization (strings up to the capacity of an
+    empty string, 15 chars in libstdc++, are stored inside the string object). Doesn't
+    count malloc's own bookkeeping, which adds about 16 bytes per allocation.
+    */
+    size_t MemoryUsage() const
+    {
+        size_t bytes{sizeof(Record)};
+        for (const std::string *s : {&name, &phone_number, &display})
+        {
+            if (s->capacity() > std::string().capacity())
+            {
+                bytes += s->capacity() + 1;
+            }
+        }
+        return bytes;
+    }
+};
+
+inline bool SortOnPhoneNumber(const Record &lhs, const Record &rhs)
+{
+    return lhs.phone_number < rhs.phone_number;
+}
+
+#endif
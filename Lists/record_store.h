@@ -0,0 +1,157 @@
+#ifndef RECORD_STORE_H
+#define RECORD_STORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+/*
+A compact alternative to keeping millions of Records (see record.h) in a container.
+Each Record owns three strings, and display repeats name and phone_number just so
+operator const char * has something to point at. Once a string is longer than the
+small string optimization allows that's a separate heap allocation, so a Record with a
+long name costs three mallocs and around twice the bytes of the text it holds.
+
+RecordStore copies the bytes of name and phone_number back to back into big shared
+blocks (an arena), and keeps a 16 byte handle per record pointing at them: two strings
+cost one bump of a pointer instead of two to three mallocs. Blocks are never moved or
+freed until the store goes away, so the string_views it hands out stay valid while the
+store is alive, however many records are added after them. The display form isn't
+stored at all, Display writes it into a buffer the caller owns when it's needed.
+
+Records are numbered in the order they were added. There's no removing a record, since
+the arena can't reuse the space (see Record for a type that can be erased from a list).
+*/
+
+// Size of each arena block, a string pair longer than this gets a block of its own
+constexpr size_t RECORD_ARENA_BLOCK_SIZE{1 << 16};
+
+class RecordStore
+{
+private:
+    // name starts at data, phone_number straight after it
+    struct Handle
+    {
+        const char *data;
+        uint32_t name_size;
+        uint32_t phone_number_size;
+    };
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    // Chars used and available in blocks.back()
+    size_t block_used;
+    size_t block_capacity;
+    size_t arena_bytes;
+    std::vector<Handle> handles;
+
+    // n chars of arena space, from the current block if they fit
+    char *Allocate(size_t n)
+    {
+        if (n > RECORD_ARENA_BLOCK_SIZE)
+        {
+            // Put in front of the current block, which keeps its free space for later records
+            auto itr{blocks.insert(blocks.empty() ? blocks.end() : blocks.end() - 1, std::make_unique_for_overwrite<char[]>(n))};
+            arena_bytes += n;
+            return itr->get();
+        }
+        // Checking for no blocks too, n can be 0 (an empty name and phone number) on a new store
+        if (blocks.empty() || block_capacity - block_used < n)
+        {
+            blocks.push_back(std::make_unique_for_overwrite<char[]>(RECORD_ARENA_BLOCK_SIZE));
+            block_used = 0;
+            block_capacity = RECORD_ARENA_BLOCK_SIZE;
+            arena_bytes += RECORD_ARENA_BLOCK_SIZE;
+        }
+        char *space{blocks.back().get() + block_used};
+        block_used += n;
+        return space;
+    }
+
+public:
+    RecordStore() : block_used(0), block_capacity(0), arena_bytes(0) {}
+
+    // Room for n records' handles (the arena grows a block at a time anyway)
+    void reserve(size_t n)
+    {
+        handles.reserve(n);
+    }
+
+    // Copies name and phone_number in, returns the new record's number
+    size_t Add(std::string_view name, std::string_view phone_number)
+    {
+        if (name.size() > std::numeric_limits<uint32_t>::max() || phone_number.size() > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::length_error("RecordStore strings are limited to 4 GB");
+        }
+        char *data{Allocate(name.size() + phone_number.size())};
+        name.copy(data, name.size());
+        phone_number.copy(data + name.size(), phone_number.size());
+        handles.push_back({data, static_cast<uint32_t>(name.size()), static_cast<uint32_t>(phone_number.size())});
+        return handles.size() - 1;
+    }
+
+    size_t size() const
+    {
+        return handles.size();
+    }
+
+    std::string_view Name(size_t i) const
+    {
+        return {handles[i].data, handles[i].name_size};
+    }
+
+    std::string_view PhoneNumber(size_t i) const
+    {
+        return {handles[i].data + handles[i].name_size, handles[i].phone_number_size};
+    }
+
+    // Chars Display needs for record i: "[name phone_number]" and the terminating null
+    size_t DisplaySize(size_t i) const
+    {
+        return handles[i].name_size + handles[i].phone_number_size + 4;
+    }
+
+    /*
+    Writes record i the way Record's operator const char * shows it into buffer (at least
+    DisplaySize(i) chars) and returns buffer. Reusing one buffer for every record means
+    printing a million records allocates nothing.
+    */
+    const char *Display(size_t i, char *buffer, size_t capacity) const
+    {
+        if (capacity < DisplaySize(i))
+        {
+            throw std::length_error("RecordStore::Display buffer too small");
+        }
+        const Handle &handle{handles[i]};
+        char *out{buffer};
+        *out++ = '[';
+        std::memcpy(out, handle.data, handle.name_size);
+        out += handle.name_size;
+        *out++ = ' ';
+        std::memcpy(out, handle.data + handle.name_size, handle.phone_number_size);
+        out += handle.phone_number_size;
+        *out++ = ']';
+        *out = '\0';
+        return buffer;
+    }
+
+    // Everything the store has allocated, including unused space at the end of blocks and vectors
+    size_t MemoryUsage() const
+    {
+        return sizeof(RecordStore) + blocks.capacity() * sizeof(blocks[0]) + arena_bytes + handles.capacity() * sizeof(Handle);
+    }
+
+    // To compare with Record::MemoryUsage
+    double BytesPerRecord() const
+    {
+        return handles.empty() ? 0.0 : static_cast<double>(MemoryUsage()) / handles.size();
+    }
+};
+
+#endif
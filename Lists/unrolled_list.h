@@ -0,0 +1,493 @@
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+An unrolled linked list: a doubly linked list whose nodes each hold a small array of up
+to NodeCapacity elements instead of one, see: https://en.wikipedia.org/wiki/Unrolled_linked_list
+
+Walking a std::list is a cache miss per element, since every node is its own allocation
+somewhere in memory and the next one can't be found until the current one has been
+loaded. Here the elements of a node sit next to each other, so a walk loads a new node
+only every NodeCapacity elements and the hardware prefetcher can stream through each
+one; the default capacity fills about UNROLLED_LIST_NODE_BYTES (4 cache lines' worth).
+
+Inserting or erasing shifts the elements after it within its node only, O(NodeCapacity)
+which is O(1). A full node is split in two halves (except when inserting after its last
+element, then the new element just starts a new node, so push_back fills nodes
+completely), and a node whose elements would fit into half of the previous one after an
+erase is merged into it, so erasing runs of elements doesn't leave a trail of almost
+empty nodes behind.
+
+Iterators are (node, index) pairs, so besides ++ and -- they can advance(n), which skips
+whole nodes at a time: O(n / NodeCapacity) rather than the O(n) of std::next on a list
+iterator (which is why main.cpp can't do + n with one). Unlike std::list, inserting or
+erasing invalidates iterators to the elements of the node(s) it touched (elements move
+within and between nodes), like vector's insert does past the insertion point.
+*/
+
+// Roughly how big each node's array of elements is
+constexpr size_t UNROLLED_LIST_NODE_BYTES{256};
+
+template <typename T, size_t NodeCapacity = std::max<size_t>(4, UNROLLED_LIST_NODE_BYTES / sizeof(T))>
+class UnrolledList
+{
+private:
+    static_assert(NodeCapacity >= 2, "UnrolledList nodes need room for at least two elements to split");
+
+    // The list's end (sentinel) node is only links, real nodes also hold elements
+    struct Links
+    {
+        Links *prev;
+        Links *next;
+    };
+
+    struct Node : Links
+    {
+        size_t count;
+        alignas(T) std::byte storage[NodeCapacity * sizeof(T)];
+
+        T *Slot(size_t i)
+        {
+            return std::launder(reinterpret_cast<T *>(storage) + i);
+        }
+    };
+
+    Links head;
+    size_t total;
+
+    static Node *NodeOf(Links *links)
+    {
+        return static_cast<Node *>(links);
+    }
+
+    Node *NewNodeAfter(Links *position)
+    {
+        Node *node{new Node};
+        node->count = 0;
+        node->prev = position;
+        node->next = position->next;
+        position->next->prev = node;
+        position->next = node;
+        return node;
+    }
+
+    void DeleteNode(Node *node)
+    {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        std::destroy(node->Slot(0), node->Slot(node->count));
+        delete node;
+    }
+
+    // Moves node's elements from index from on to the end of to
+    static void MoveElements(Node *from_node, size_t from, Node *to)
+    {
+        for (size_t i = from; i < from_node->count; i++)
+        {
+            std::construct_at(to->Slot(to->count++), std::move(*from_node->Slot(i)));
+            std::destroy_at(from_node->Slot(i));
+        }
+        from_node->count = std::min(from_node->count, from);
+    }
+
+    // Constructs an element at index i of node (which has room), shifting the ones after it up
+    template <typename... Args>
+    static void EmplaceInNode(Node *node, size_t i, Args &&...args)
+    {
+        if (i == node->count)
+        {
+            std::construct_at(node->Slot(i), std::forward<Args>(args)...);
+        }
+        else
+        {
+            // Built first, args might refer to an element that's about to move
+            T value(std::forward<Args>(args)...);
+            std::construct_at(node->Slot(node->count), std::move(*node->Slot(node->count - 1)));
+            std::move_backward(node->Slot(i), node->Slot(node->count - 1), node->Slot(node->count));
+            *node->Slot(i) = std::move(value);
+        }
+        node->count++;
+    }
+
+    /*
+    Inserts before index i of node (or at the end when node is the head), returns where
+    the new element ended up.
+    */
+    template <typename... Args>
+    std::pair<Links *, size_t> Emplace(Links *links, size_t i, Args &&...args)
+    {
+        total++;
+        // Before the first element of a node, or at the end of the list: the end of the previous node is the same place
+        if (i == 0 && links->prev != &head && NodeOf(links->prev)->count < NodeCapacity)
+        {
+            Node *prev{NodeOf(links->prev)};
+            EmplaceInNode(prev, prev->count, std::forward<Args>(args)...);
+            return {prev, prev->count - 1};
+        }
+        if (links == &head || (i == 0 && NodeOf(links)->count == NodeCapacity))
+        {
+            Node *node{NewNodeAfter(links->prev)};
+            EmplaceInNode(node, 0, std::forward<Args>(args)...);
+            return {node, 0};
+        }
+        Node *node{NodeOf(links)};
+        if (node->count == NodeCapacity)
+        {
+            // Built before the split, args might refer to one of the elements it moves
+            T value(std::forward<Args>(args)...);
+            Node *upper{NewNodeAfter(node)};
+            MoveElements(node, NodeCapacity / 2, upper);
+            if (i > NodeCapacity / 2)
+            {
+                node = upper;
+                i -= NodeCapacity / 2;
+            }
+            EmplaceInNode(node, i, std::move(value));
+            return {node, i};
+        }
+        EmplaceInNode(node, i, std::forward<Args>(args)...);
+        return {node, i};
+    }
+
+    // Erases index i of node, returns the position of the element that followed it
+    std::pair<Links *, size_t> Erase(Node *node, size_t i)
+    {
+        total--;
+        std::move(node->Slot(i + 1), node->Slot(node->count), node->Slot(i));
+        std::destroy_at(node->Slot(node->count - 1));
+        node->count--;
+        if (node->count == 0)
+        {
+            Links *next{node->next};
+            DeleteNode(node);
+            return {next, 0};
+        }
+        // Merging this node into the previous one, when they're both sparse, keeps nodes from emptying out one by one
+        if (node->prev != &head && NodeOf(node->prev)->count + node->count <= NodeCapacity / 2)
+        {
+            Node *prev{NodeOf(node->prev)};
+            size_t offset{prev->count};
+            MoveElements(node, 0, prev);
+            Links *next{node->next};
+            DeleteNode(node);
+            return i < prev->count - offset ? std::pair<Links *, size_t>{prev, offset + i} : std::pair<Links *, size_t>{next, 0};
+        }
+        if (i == node->count)
+        {
+            return {node->next, 0};
+        }
+        return {node, i};
+    }
+
+    template <bool Const>
+    class Iterator
+    {
+    private:
+        friend class UnrolledList;
+        template <bool>
+        friend class Iterator;
+        Links *links;
+        size_t index;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T *, T *>;
+        using reference = std::conditional_t<Const, const T &, T &>;
+
+        Iterator() : links(nullptr), index(0) {}
+        Iterator(Links *l, size_t i) : links(l), index(i) {}
+
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst> &other) : links(other.links), index(other.index) {}
+
+        reference operator*() const
+        {
+            return *NodeOf(links)->Slot(index);
+        }
+
+        pointer operator->() const
+        {
+            return NodeOf(links)->Slot(index);
+        }
+
+        Iterator &operator++()
+        {
+            if (++index == NodeOf(links)->count)
+            {
+                links = links->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old{*this};
+            ++*this;
+            return old;
+        }
+
+        Iterator &operator--()
+        {
+            if (index == 0)
+            {
+                links = links->prev;
+                index = NodeOf(links)->count;
+            }
+            index--;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            Iterator old{*this};
+            --*this;
+            return old;
+        }
+
+        /*
+        Moves n elements forwards (or back for negative n), a whole node at a time where it
+        can. Moving past either end of the list is undefined, as for std::advance.
+        */
+        Iterator &advance(difference_type n)
+        {
+            size_t steps{static_cast<size_t>(n < 0 ? -n : n)};
+            if (n >= 0)
+            {
+                while (steps > 0 && steps >= NodeOf(links)->count - index)
+                {
+                    steps -= NodeOf(links)->count - index;
+                    links = links->next;
+                    index = 0;
+                }
+                index += steps;
+            }
+            else
+            {
+                while (steps > index)
+                {
+                    steps -= index + 1;
+                    links = links->prev;
+                    index = NodeOf(links)->count - 1;
+                }
+                index -= steps;
+            }
+            return *this;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return links == other.links && index == other.index;
+        }
+    };
+
+public:
+    using value_type = T;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    UnrolledList() : total(0)
+    {
+        head.prev = &head;
+        head.next = &head;
+    }
+
+    template <typename InputIt>
+    UnrolledList(InputIt first, InputIt last) : UnrolledList()
+    {
+        for (; first != last; ++first)
+        {
+            push_back(*first);
+        }
+    }
+
+    UnrolledList(std::initializer_list<T> values) : UnrolledList(values.begin(), values.end()) {}
+
+    UnrolledList(const UnrolledList &other) : UnrolledList(other.cbegin(), other.cend()) {}
+
+    UnrolledList(UnrolledList &&other) noexcept : UnrolledList()
+    {
+        swap(other);
+    }
+
+    UnrolledList &operator=(UnrolledList other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~UnrolledList()
+    {
+        clear();
+    }
+
+    // The first and last nodes point at head, so they have to be pointed at the other list's head
+    void swap(UnrolledList &other) noexcept
+    {
+        std::swap(head, other.head);
+        std::swap(total, other.total);
+        for (UnrolledList *list : {this, &other})
+        {
+            if (list->total == 0)
+            {
+                list->head.prev = &list->head;
+                list->head.next = &list->head;
+            }
+            else
+            {
+                list->head.next->prev = &list->head;
+                list->head.prev->next = &list->head;
+            }
+        }
+    }
+
+    iterator begin()
+    {
+        return iterator(head.next, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(&head, 0);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(head.next, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(const_cast<Links *>(&head), 0);
+    }
+
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    size_t size() const
+    {
+        return total;
+    }
+
+    bool empty() const
+    {
+        return total == 0;
+    }
+
+    T &front()
+    {
+        return *begin();
+    }
+
+    T &back()
+    {
+        return *NodeOf(head.prev)->Slot(NodeOf(head.prev)->count - 1);
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator position, Args &&...args)
+    {
+        auto [links, index]{Emplace(position.links, position.index, std::forward<Args>(args)...)};
+        return iterator(links, index);
+    }
+
+    iterator insert(const_iterator position, const T &value)
+    {
+        return emplace(position, value);
+    }
+
+    iterator insert(const_iterator position, T &&value)
+    {
+        return emplace(position, std::move(value));
+    }
+
+    void push_back(const T &value)
+    {
+        Emplace(&head, 0, value);
+    }
+
+    void push_back(T &&value)
+    {
+        Emplace(&head, 0, std::move(value));
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        Emplace(&head, 0, std::forward<Args>(args)...);
+        return back();
+    }
+
+    void push_front(const T &value)
+    {
+        Emplace(head.next, 0, value);
+    }
+
+    void push_front(T &&value)
+    {
+        Emplace(head.next, 0, std::move(value));
+    }
+
+    void pop_front()
+    {
+        Erase(NodeOf(head.next), 0);
+    }
+
+    void pop_back()
+    {
+        Erase(NodeOf(head.prev), NodeOf(head.prev)->count - 1);
+    }
+
+    // Returns the position of the element after the erased one, as list::erase does
+    iterator erase(const_iterator position)
+    {
+        auto [links, index]{Erase(NodeOf(position.links), position.index)};
+        return iterator(links, index);
+    }
+
+    // Erases count(first, last) elements one at a time, each erase returns where the next one now is
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        size_t n{0};
+        for (const_iterator itr = first; itr != last; ++itr)
+        {
+            n++;
+        }
+        iterator position(first.links, first.index);
+        for (size_t i = 0; i < n; i++)
+        {
+            position = erase(position);
+        }
+        return position;
+    }
+
+    void clear()
+    {
+        while (head.next != &head)
+        {
+            DeleteNode(NodeOf(head.next));
+        }
+        total = 0;
+    }
+};
+
+#endif
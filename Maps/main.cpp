@@ -3,16 +3,8 @@
 #include <unordered_map>
 #include <string>
 
-template <typename T>
-void DisplayMap(const T &container)
-{
-    std::cout << "[ ";
-    for (auto itr = container.cbegin(); itr != container.cend(); itr++)
-    {
-        std::cout << "(" << itr->first << ", " << itr->second << ") ";
-    }
-    std::cout << "] size = " << container.size() << std::endl;
-}
+// DisplayContainer and DisplayMap are shared with other folders, see Common/display.h
+#include "../Common/display.h"
 
 template <typename T>
 struct SortDescending
@@ -3,16 +3,8 @@
 #include <vector>
 #include <unordered_set>
 
-template <typename T>
-void DisplayContainer(const T &container)
-{
-    std::cout << "[ ";
-    for (auto itr = container.cbegin(); itr != container.cend(); itr++)
-    {
-        std::cout << *itr << " ";
-    }
-    std::cout << "] size = " << container.size() << std::endl;
-}
+// DisplayContainer and DisplayMap are shared with other folders, see Common/display.h
+#include "../Common/display.h"
 
 template <typename T>
 struct SortDescending